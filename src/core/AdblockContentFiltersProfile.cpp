@@ -27,19 +27,27 @@
 #include <QtConcurrent/QtConcurrentRun>
 #include <QtCore/QBuffer>
 #include <QtCore/QCoreApplication>
+#include <QtCore/QDataStream>
 #include <QtCore/QDir>
+#include <QtCore/QFileInfo>
 #include <QtCore/QSaveFile>
 #include <QtCore/QTextStream>
 
+#define RULES_CACHE_MAGIC 0x4F414243
+#define RULES_CACHE_VERSION 3
+
 namespace Otter
 {
 
+QRegularExpression AdblockContentFiltersProfile::m_domainExpression(QLatin1String("[:\?&/=]"));
 QHash<QString, AdblockContentFiltersProfile::RuleOption> AdblockContentFiltersProfile::m_options({{QLatin1String("third-party"), ThirdPartyOption}, {QLatin1String("stylesheet"), StyleSheetOption}, {QLatin1String("image"), ImageOption}, {QLatin1String("script"), ScriptOption}, {QLatin1String("object"), ObjectOption}, {QLatin1String("object-subrequest"), ObjectSubRequestOption}, {QLatin1String("object_subrequest"), ObjectSubRequestOption}, {QLatin1String("subdocument"), SubDocumentOption}, {QLatin1String("xmlhttprequest"), XmlHttpRequestOption}, {QLatin1String("websocket"), WebSocketOption}, {QLatin1String("popup"), PopupOption}, {QLatin1String("elemhide"), ElementHideOption}, {QLatin1String("generichide"), GenericHideOption}});
 QHash<NetworkManager::ResourceType, AdblockContentFiltersProfile::RuleOption> AdblockContentFiltersProfile::m_resourceTypes({{NetworkManager::ImageType, ImageOption}, {NetworkManager::ScriptType, ScriptOption}, {NetworkManager::StyleSheetType, StyleSheetOption}, {NetworkManager::ObjectType, ObjectOption}, {NetworkManager::XmlHttpRequestType, XmlHttpRequestOption}, {NetworkManager::SubFrameType, SubDocumentOption},{NetworkManager::PopupType, PopupOption}, {NetworkManager::ObjectSubrequestType, ObjectSubRequestOption}, {NetworkManager::WebSocketType, WebSocketOption}});
+QCache<QVector<int>, QSharedPointer<AdblockContentFiltersProfile::MergedRuleSet> > AdblockContentFiltersProfile::m_mergedRuleSets(8);
+QMutex AdblockContentFiltersProfile::m_mergedRuleSetsMutex;
 
 AdblockContentFiltersProfile::AdblockContentFiltersProfile(const ContentFiltersProfile::ProfileSummary &profileSummary, const QStringList &languages, ContentFiltersProfile::ProfileFlags flags, QObject *parent) : ContentFiltersProfile(parent),
-	m_root(nullptr),
 	m_dataFetchJob(nullptr),
+	m_ruleSetWatcher(nullptr),
 	m_profileSummary(profileSummary),
 	m_error(NoError),
 	m_flags(flags),
@@ -75,16 +83,13 @@ void AdblockContentFiltersProfile::clear()
 		return;
 	}
 
-	if (m_root)
-	{
-		QtConcurrent::run(this, &AdblockContentFiltersProfile::deleteNode, m_root);
-	}
-
-	m_cosmeticFiltersRules.clear();
-	m_cosmeticFiltersDomainExceptions.clear();
-	m_cosmeticFiltersDomainRules.clear();
+	m_ruleSetWatcher = nullptr;
 
+	m_ruleSetMutex.lock();
+	removeMergedRuleSets(m_ruleSet);
+	m_ruleSet.reset();
 	m_wasLoaded = false;
+	m_ruleSetMutex.unlock();
 }
 
 void AdblockContentFiltersProfile::loadHeader()
@@ -127,7 +132,7 @@ void AdblockContentFiltersProfile::loadHeader()
 	}
 }
 
-void AdblockContentFiltersProfile::parseRuleLine(const QString &rule)
+void AdblockContentFiltersProfile::parseRuleLine(const QString &rule, const ProfileSummary &profileSummary, RuleSet *ruleSet)
 {
 	if (rule.isEmpty() || rule.startsWith(QLatin1Char('!')))
 	{
@@ -136,9 +141,9 @@ void AdblockContentFiltersProfile::parseRuleLine(const QString &rule)
 
 	if (rule.startsWith(QLatin1String("##")))
 	{
-		if (m_profileSummary.cosmeticFiltersMode == ContentFiltersManager::AllFilters)
+		if (profileSummary.cosmeticFiltersMode == ContentFiltersManager::AllFilters)
 		{
-			m_cosmeticFiltersRules.append(rule.mid(2));
+			ruleSet->cosmeticFiltersRules.append(rule.mid(2));
 		}
 
 		return;
@@ -146,9 +151,9 @@ void AdblockContentFiltersProfile::parseRuleLine(const QString &rule)
 
 	if (rule.contains(QLatin1String("##")))
 	{
-		if (m_profileSummary.cosmeticFiltersMode != ContentFiltersManager::NoFilters)
+		if (profileSummary.cosmeticFiltersMode != ContentFiltersManager::NoFilters)
 		{
-			parseStyleSheetRule(rule.split(QLatin1String("##")), m_cosmeticFiltersDomainRules);
+			parseStyleSheetRule(rule.split(QLatin1String("##")), ruleSet->cosmeticFiltersDomainRules);
 		}
 
 		return;
@@ -156,9 +161,9 @@ void AdblockContentFiltersProfile::parseRuleLine(const QString &rule)
 
 	if (rule.contains(QLatin1String("#@#")))
 	{
-		if (m_profileSummary.cosmeticFiltersMode != ContentFiltersManager::NoFilters)
+		if (profileSummary.cosmeticFiltersMode != ContentFiltersManager::NoFilters)
 		{
-			parseStyleSheetRule(rule.split(QLatin1String("#@#")), m_cosmeticFiltersDomainExceptions);
+			parseStyleSheetRule(rule.split(QLatin1String("#@#")), ruleSet->cosmeticFiltersDomainExceptions);
 		}
 
 		return;
@@ -183,37 +188,37 @@ void AdblockContentFiltersProfile::parseRuleLine(const QString &rule)
 		line = line.mid(1);
 	}
 
-	if (!m_profileSummary.areWildcardsEnabled && line.contains(QLatin1Char('*')))
+	if (!profileSummary.areWildcardsEnabled && line.contains(QLatin1Char('*')))
 	{
 		return;
 	}
 
-	Node::Rule *definition(new Node::Rule());
-	definition->rule = rule;
-	definition->isException = line.startsWith(QLatin1String("@@"));
+	Rule definition;
+	definition.rule = rule;
+	definition.isException = line.startsWith(QLatin1String("@@"));
 
-	if (definition->isException)
+	if (definition.isException)
 	{
 		line = line.mid(2);
 	}
 
-	definition->needsDomainCheck = line.startsWith(QLatin1String("||"));
+	definition.needsDomainCheck = line.startsWith(QLatin1String("||"));
 
-	if (definition->needsDomainCheck)
+	if (definition.needsDomainCheck)
 	{
 		line = line.mid(2);
 	}
 
 	if (line.startsWith(QLatin1Char('|')))
 	{
-		definition->ruleMatch = StartMatch;
+		definition.ruleMatch = StartMatch;
 
 		line = line.mid(1);
 	}
 
 	if (line.endsWith(QLatin1Char('|')))
 	{
-		definition->ruleMatch = ((definition->ruleMatch == StartMatch) ? ExactMatch : EndMatch);
+		definition.ruleMatch = ((definition.ruleMatch == StartMatch) ? ExactMatch : EndMatch);
 
 		line = line.left(line.length() - 1);
 	}
@@ -227,18 +232,18 @@ void AdblockContentFiltersProfile::parseRuleLine(const QString &rule)
 		{
 			const RuleOption option(m_options.value(optionName));
 
-			if ((!definition->isException || isOptionException) && (option == ElementHideOption || option == GenericHideOption))
+			if ((!definition.isException || isOptionException) && (option == ElementHideOption || option == GenericHideOption))
 			{
 				continue;
 			}
 
 			if (!isOptionException)
 			{
-				definition->ruleOptions |= option;
+				definition.ruleOptions |= option;
 			}
 			else if (option != WebSocketOption && option != PopupOption)
 			{
-				definition->ruleExceptions |= option;
+				definition.ruleExceptions |= option;
 			}
 		}
 		else if (optionName.startsWith(QLatin1String("domain")))
@@ -249,12 +254,12 @@ void AdblockContentFiltersProfile::parseRuleLine(const QString &rule)
 			{
 				if (parsedDomains.at(j).startsWith(QLatin1Char('~')))
 				{
-					definition->allowedDomains.append(parsedDomains.at(j).mid(1));
+					definition.allowedDomains.append(parsedDomains.at(j).mid(1));
 
 					continue;
 				}
 
-				definition->blockedDomains.append(parsedDomains.at(j));
+				definition.blockedDomains.append(parsedDomains.at(j));
 			}
 		}
 		else
@@ -263,84 +268,172 @@ void AdblockContentFiltersProfile::parseRuleLine(const QString &rule)
 		}
 	}
 
-	Node *node(m_root);
+	definition.pattern = line;
 
-	for (int i = 0; i < line.length(); ++i)
-	{
-		const QChar value(line.at(i));
-		bool childrenExists(false);
+	ruleSet->rules.append(definition);
+}
 
-		for (int j = 0; j < node->children.count(); ++j)
-		{
-			Node *nextNode(node->children.at(j));
+void AdblockContentFiltersProfile::parseStyleSheetRule(const QStringList &line, QHash<QString, QStringList> &list)
+{
+	const QStringList domains(line.at(0).split(QLatin1Char(',')));
 
-			if (nextNode->value == value)
-			{
-				node = nextNode;
+	for (int i = 0; i < domains.count(); ++i)
+	{
+		list[domains.at(i)].append(line.at(1));
+	}
+}
+
+void AdblockContentFiltersProfile::createRulesIndex(RuleSet *ruleSet)
+{
+	QHash<quint64, int> frequencies;
 
-				childrenExists = true;
+	for (int i = 0; i < ruleSet->rules.count(); ++i)
+	{
+		const QString &pattern(ruleSet->rules.at(i).pattern);
+		const int anchoredLength(pattern.contains(QLatin1Char('*')) ? pattern.indexOf(QLatin1Char('*')) : pattern.length());
 
-				break;
+		for (int j = 0; j <= (anchoredLength - 4); ++j)
+		{
+			if (pattern.midRef(j, 4).contains(QLatin1Char('^')))
+			{
+				continue;
 			}
+
+			++frequencies[createTokenKey(pattern, j)];
 		}
+	}
 
-		if (!childrenExists)
+	for (int i = 0; i < ruleSet->rules.count(); ++i)
+	{
+		Rule &rule(ruleSet->rules[i]);
+		const QString &pattern(rule.pattern);
+		const int anchoredLength(pattern.contains(QLatin1Char('*')) ? pattern.indexOf(QLatin1Char('*')) : pattern.length());
+		quint64 bestToken(0);
+		int bestFrequency(-1);
+		int separatorsAmount(0);
+
+		for (int j = 0; j <= (anchoredLength - 4); ++j)
 		{
-			Node *newNode(new Node());
-			newNode->value = value;
+			if (pattern.at(j) == QLatin1Char('^'))
+			{
+				++separatorsAmount;
+			}
 
-			if (value == QLatin1Char('^'))
+			if (pattern.midRef(j, 4).contains(QLatin1Char('^')))
 			{
-				node->children.insert(0, newNode);
+				continue;
 			}
-			else
+
+			const quint64 token(createTokenKey(pattern, j));
+			const int frequency(frequencies.value(token));
+
+			if (bestFrequency < 0 || frequency < bestFrequency)
 			{
-				node->children.append(newNode);
+				bestToken = token;
+				bestFrequency = frequency;
+
+				rule.tokenOffset = (j - separatorsAmount);
 			}
+		}
 
-			node = newNode;
+		if (bestFrequency < 0)
+		{
+			ruleSet->unindexedRules.append(i);
+		}
+		else
+		{
+			ruleSet->tokens[bestToken].append(i);
 		}
 	}
 
-	node->rules.append(definition);
+	ruleSet->rules.squeeze();
+	ruleSet->unindexedRules.squeeze();
 }
 
-void AdblockContentFiltersProfile::parseStyleSheetRule(const QStringList &line, QMultiHash<QString, QString> &list)
+void AdblockContentFiltersProfile::deleteRuleSet(RuleSet *ruleSet)
 {
-	const QStringList domains(line.at(0).split(QLatin1Char(',')));
+	QtConcurrent::run([=]()
+	{
+		delete ruleSet;
+	});
+}
 
-	for (int i = 0; i < domains.count(); ++i)
+QSharedPointer<AdblockContentFiltersProfile::MergedRuleSet> AdblockContentFiltersProfile::createMergedRuleSet(const QVector<int> &profiles, const QVector<QSharedPointer<RuleSet> > &ruleSets)
+{
+	QSharedPointer<MergedRuleSet> mergedRuleSet(new MergedRuleSet());
+	mergedRuleSet->profiles = profiles;
+	mergedRuleSet->ruleSets = ruleSets;
+
+	for (int i = 0; i < ruleSets.count(); ++i)
 	{
-		list.insert(domains.at(i), line.at(1));
+		const RuleSet *ruleSet(ruleSets.at(i).data());
+
+		if (!ruleSet)
+		{
+			continue;
+		}
+
+		QHash<quint64, QVector<int> >::const_iterator iterator;
+
+		for (iterator = ruleSet->tokens.constBegin(); iterator != ruleSet->tokens.constEnd(); ++iterator)
+		{
+			QVector<MergedRuleSet::RuleReference> &rules(mergedRuleSet->tokens[iterator.key()]);
+			rules.reserve(rules.count() + iterator.value().count());
+
+			for (int j = 0; j < iterator.value().count(); ++j)
+			{
+				rules.append({i, iterator.value().at(j)});
+			}
+		}
+
+		for (int j = 0; j < ruleSet->unindexedRules.count(); ++j)
+		{
+			mergedRuleSet->unindexedRules.append({i, ruleSet->unindexedRules.at(j)});
+		}
 	}
+
+	return mergedRuleSet;
 }
 
-void AdblockContentFiltersProfile::deleteNode(Node *node) const
+void AdblockContentFiltersProfile::removeMergedRuleSets(const QSharedPointer<RuleSet> &ruleSet)
 {
-	for (int i = 0; i < node->children.count(); ++i)
+	if (!ruleSet)
 	{
-		deleteNode(node->children.at(i));
+		return;
 	}
 
-	for (int i = 0; i < node->rules.count(); ++i)
+	QMutexLocker locker(&m_mergedRuleSetsMutex);
+	const QList<QVector<int> > keys(m_mergedRuleSets.keys());
+
+	for (int i = 0; i < keys.count(); ++i)
 	{
-		delete node->rules.at(i);
+		if (m_mergedRuleSets.object(keys.at(i))->data()->ruleSets.contains(ruleSet))
+		{
+			m_mergedRuleSets.remove(keys.at(i));
+		}
 	}
+}
 
-	delete node;
+quint64 AdblockContentFiltersProfile::createTokenKey(const QString &text, int position)
+{
+	return ((static_cast<quint64>(text.at(position).unicode()) << 48) | (static_cast<quint64>(text.at(position + 1).unicode()) << 32) | (static_cast<quint64>(text.at(position + 2).unicode()) << 16) | static_cast<quint64>(text.at(position + 3).unicode()));
 }
 
-ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkUrlSubstring(const Node *node, const QString &subString, QString currentRule, const Request &request) const
+ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkRules(const RuleSet *ruleSet, const QVector<int> &rules, const Request &request, int tokenPosition)
 {
 	ContentFiltersManager::CheckResult result;
-	ContentFiltersManager::CheckResult currentResult;
 
-	for (int i = 0; i < subString.length(); ++i)
+	for (int i = 0; i < rules.count(); ++i)
 	{
-		const QChar treeChar(subString.at(i));
-		bool childrenExists(false);
+		const Rule &rule(ruleSet->rules.at(rules.at(i)));
+		const int urlStart((tokenPosition < 0) ? -1 : (tokenPosition - rule.tokenOffset));
 
-		currentResult = evaluateNodeRules(node, currentRule, request);
+		if (tokenPosition >= 0 && urlStart < 0)
+		{
+			continue;
+		}
+
+		const ContentFiltersManager::CheckResult currentResult(checkRule(rule, request, urlStart));
 
 		if (currentResult.isBlocked)
 		{
@@ -350,96 +443,72 @@ ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkUrlSubstri
 		{
 			return currentResult;
 		}
+	}
 
-		for (int j = 0; j < node->children.count(); ++j)
-		{
-			const Node *nextNode(node->children.at(j));
-
-			if (nextNode->value == QLatin1Char('*'))
-			{
-				const QString wildcardSubString(subString.mid(i));
-
-				for (int k = 0; k < wildcardSubString.length(); ++k)
-				{
-					currentResult = checkUrlSubstring(nextNode, wildcardSubString.right(wildcardSubString.length() - k), (currentRule + wildcardSubString.left(k)), request);
-
-					if (currentResult.isBlocked)
-					{
-						result = currentResult;
-					}
-					else if (currentResult.isException)
-					{
-						return currentResult;
-					}
-				}
-			}
+	return result;
+}
 
-			if (nextNode->value == QLatin1Char('^') && !treeChar.isDigit() && !treeChar.isLetter() && treeChar != QLatin1Char('_') && treeChar != QLatin1Char('-') && treeChar != QLatin1Char('.') && treeChar != QLatin1Char('%'))
-			{
-				currentResult = checkUrlSubstring(nextNode, subString.mid(i), currentRule, request);
+ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkMergedRules(const MergedRuleSet *mergedRuleSet, const QVector<MergedRuleSet::RuleReference> &rules, const Request &request, int tokenPosition)
+{
+	ContentFiltersManager::CheckResult result;
 
-				if (currentResult.isBlocked)
-				{
-					result = currentResult;
-				}
-				else if (currentResult.isException)
-				{
-					return currentResult;
-				}
-			}
+	for (int i = 0; i < rules.count(); ++i)
+	{
+		const MergedRuleSet::RuleReference &reference(rules.at(i));
+		const Rule &rule(mergedRuleSet->ruleSets.at(reference.ruleSet)->rules.at(reference.rule));
+		const int urlStart((tokenPosition < 0) ? -1 : (tokenPosition - rule.tokenOffset));
 
-			if (nextNode->value == treeChar)
-			{
-				node = nextNode;
+		if (tokenPosition >= 0 && urlStart < 0)
+		{
+			continue;
+		}
 
-				childrenExists = true;
+		ContentFiltersManager::CheckResult currentResult(checkRule(rule, request, urlStart));
+		currentResult.profile = mergedRuleSet->profiles.at(reference.ruleSet);
 
-				break;
-			}
+		if (currentResult.isBlocked)
+		{
+			result = currentResult;
 		}
-
-		if (!childrenExists)
+		else if (currentResult.isException)
 		{
-			return result;
+			return currentResult;
 		}
-
-		currentRule += treeChar;
 	}
 
-	currentResult = evaluateNodeRules(node, currentRule, request);
+	return result;
+}
 
-	if (currentResult.isBlocked)
+ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkRule(const Rule &rule, const Request &request, int urlStart)
+{
+	if (rule.pattern.isEmpty())
 	{
-		result = currentResult;
+		return (request.requestUrl.isEmpty() ? ContentFiltersManager::CheckResult() : checkRuleMatch(rule, {}, request));
 	}
-	else if (currentResult.isException)
+
+	if (urlStart >= 0)
 	{
-		return currentResult;
+		ContentFiltersManager::CheckResult result;
+
+		return (matchPattern(rule, 0, urlStart, urlStart, request, result) ? result : ContentFiltersManager::CheckResult());
 	}
 
-	for (int i = 0; i < node->children.count(); ++i)
+	for (int i = 0; i < request.requestUrl.length(); ++i)
 	{
-		if (node->children.at(i)->value == QLatin1Char('^'))
-		{
-			currentResult = evaluateNodeRules(node, currentRule, request);
+		ContentFiltersManager::CheckResult result;
 
-			if (currentResult.isBlocked)
-			{
-				result = currentResult;
-			}
-			else if (currentResult.isException)
-			{
-				return currentResult;
-			}
+		if (matchPattern(rule, 0, i, i, request, result))
+		{
+			return result;
 		}
 	}
 
-	return result;
+	return {};
 }
 
-ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkRuleMatch(const Node::Rule *rule, const QString &currentRule, const Request &request) const
+ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkRuleMatch(const Rule &rule, const QString &currentRule, const Request &request)
 {
-	switch (rule->ruleMatch)
+	switch (rule.ruleMatch)
 	{
 		case StartMatch:
 			if (!request.requestUrl.startsWith(currentRule))
@@ -473,18 +542,18 @@ ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkRuleMatch(
 
 	const QStringList requestSubdomainList(ContentFiltersManager::createSubdomainList(request.requestHost));
 
-	if (rule->needsDomainCheck && !requestSubdomainList.contains(currentRule.left(currentRule.indexOf(m_domainExpression))))
+	if (rule.needsDomainCheck && !requestSubdomainList.contains(currentRule.left(currentRule.indexOf(m_domainExpression))))
 	{
 		return {};
 	}
 
-	const bool hasBlockedDomains(!rule->blockedDomains.isEmpty());
-	const bool hasAllowedDomains(!rule->allowedDomains.isEmpty());
+	const bool hasBlockedDomains(!rule.blockedDomains.isEmpty());
+	const bool hasAllowedDomains(!rule.allowedDomains.isEmpty());
 	bool isBlocked(true);
 
 	if (hasBlockedDomains)
 	{
-		isBlocked = resolveDomainExceptions(request.baseHost, rule->blockedDomains);
+		isBlocked = resolveDomainExceptions(request.baseHost, rule.blockedDomains);
 
 		if (!isBlocked)
 		{
@@ -492,21 +561,21 @@ ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkRuleMatch(
 		}
 	}
 
-	isBlocked = (hasAllowedDomains ? !resolveDomainExceptions(request.baseHost, rule->allowedDomains) : isBlocked);
+	isBlocked = (hasAllowedDomains ? !resolveDomainExceptions(request.baseHost, rule.allowedDomains) : isBlocked);
 
-	if (rule->ruleOptions.testFlag(ThirdPartyOption) || rule->ruleExceptions.testFlag(ThirdPartyOption))
+	if (rule.ruleOptions.testFlag(ThirdPartyOption) || rule.ruleExceptions.testFlag(ThirdPartyOption))
 	{
 		if (request.baseHost.isEmpty() || requestSubdomainList.contains(request.baseHost))
 		{
-			isBlocked = rule->ruleExceptions.testFlag(ThirdPartyOption);
+			isBlocked = rule.ruleExceptions.testFlag(ThirdPartyOption);
 		}
 		else if (!hasBlockedDomains && !hasAllowedDomains)
 		{
-			isBlocked = rule->ruleOptions.testFlag(ThirdPartyOption);
+			isBlocked = rule.ruleOptions.testFlag(ThirdPartyOption);
 		}
 	}
 
-	if (rule->ruleOptions != NoOption || rule->ruleExceptions != NoOption)
+	if (rule.ruleOptions != NoOption || rule.ruleExceptions != NoOption)
 	{
 		QHash<NetworkManager::ResourceType, RuleOption>::const_iterator iterator;
 
@@ -514,15 +583,15 @@ ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkRuleMatch(
 		{
 			const bool supportsException(iterator.value() != WebSocketOption && iterator.value() != PopupOption);
 
-			if (rule->ruleOptions.testFlag(iterator.value()) || (supportsException && rule->ruleExceptions.testFlag(iterator.value())))
+			if (rule.ruleOptions.testFlag(iterator.value()) || (supportsException && rule.ruleExceptions.testFlag(iterator.value())))
 			{
 				if (request.resourceType == iterator.key())
 				{
-					isBlocked = (isBlocked ? rule->ruleOptions.testFlag(iterator.value()) : isBlocked);
+					isBlocked = (isBlocked ? rule.ruleOptions.testFlag(iterator.value()) : isBlocked);
 				}
 				else if (supportsException)
 				{
-					isBlocked = (isBlocked ? rule->ruleExceptions.testFlag(iterator.value()) : isBlocked);
+					isBlocked = (isBlocked ? rule.ruleExceptions.testFlag(iterator.value()) : isBlocked);
 				}
 				else
 				{
@@ -539,18 +608,18 @@ ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkRuleMatch(
 	if (isBlocked)
 	{
 		ContentFiltersManager::CheckResult result;
-		result.rule = rule->rule;
+		result.rule = rule.rule;
 
-		if (rule->isException)
+		if (rule.isException)
 		{
 			result.isBlocked = false;
 			result.isException = true;
 
-			if (rule->ruleOptions.testFlag(ElementHideOption))
+			if (rule.ruleOptions.testFlag(ElementHideOption))
 			{
 				result.comesticFiltersMode = ContentFiltersManager::NoFilters;
 			}
-			else if (rule->ruleOptions.testFlag(GenericHideOption))
+			else if (rule.ruleOptions.testFlag(GenericHideOption))
 			{
 				result.comesticFiltersMode = ContentFiltersManager::DomainOnlyFilters;
 			}
@@ -566,6 +635,46 @@ ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkRuleMatch(
 	return {};
 }
 
+void AdblockContentFiltersProfile::compileRules()
+{
+	QFutureWatcher<QSharedPointer<RuleSet> > *watcher(new QFutureWatcher<QSharedPointer<RuleSet> >(this));
+
+	m_ruleSetWatcher = watcher;
+
+	connect(watcher, &QFutureWatcher<QSharedPointer<RuleSet> >::finished, this, [=]()
+	{
+		const QSharedPointer<RuleSet> ruleSet(watcher->result());
+
+		watcher->deleteLater();
+
+		if (watcher != m_ruleSetWatcher)
+		{
+			return;
+		}
+
+		m_ruleSetWatcher = nullptr;
+
+		if (!ruleSet)
+		{
+			raiseError(QCoreApplication::translate("main", "Failed to open content blocking profile file: %1").arg(getPath()), ReadError);
+
+			return;
+		}
+
+		if (m_wasLoaded)
+		{
+			m_ruleSetMutex.lock();
+			removeMergedRuleSets(m_ruleSet);
+			m_ruleSet = ruleSet;
+			m_ruleSetMutex.unlock();
+
+			ContentFiltersManager::clearCaches();
+		}
+	});
+
+	watcher->setFuture(QtConcurrent::run(&AdblockContentFiltersProfile::parseRules, m_profileSummary, getPath(), getCachePath()));
+}
+
 void AdblockContentFiltersProfile::raiseError(const QString &message, ProfileError error)
 {
 	m_error = error;
@@ -629,15 +738,43 @@ void AdblockContentFiltersProfile::handleJobFinished(bool isSuccess)
 		Console::addMessage(QCoreApplication::translate("main", "Failed to update content blocking profile: %1").arg(file.errorString()), Console::OtherCategory, Console::ErrorLevel, file.fileName());
 	}
 
-	clear();
 	loadHeader();
+	compileRules();
 
-	if (m_wasLoaded)
+	emit profileModified();
+}
+
+void AdblockContentFiltersProfile::saveRulesCache(const RuleSet *ruleSet, const ProfileSummary &profileSummary, const QString &path, const QString &cachePath)
+{
+	const QFileInfo rulesInformation(path);
+
+	if (SessionsManager::isReadOnly() || !rulesInformation.exists())
 	{
-		loadRules();
+		return;
 	}
 
-	emit profileModified();
+	QSaveFile file(cachePath);
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		return;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_6);
+	stream << static_cast<quint32>(RULES_CACHE_MAGIC) << static_cast<quint32>(RULES_CACHE_VERSION) << static_cast<qint64>(rulesInformation.size()) << static_cast<qint64>(rulesInformation.lastModified().toMSecsSinceEpoch()) << static_cast<qint32>(profileSummary.cosmeticFiltersMode) << profileSummary.areWildcardsEnabled;
+	stream << static_cast<quint32>(ruleSet->rules.count());
+
+	for (int i = 0; i < ruleSet->rules.count(); ++i)
+	{
+		const Rule &rule(ruleSet->rules.at(i));
+
+		stream << rule.rule << rule.pattern << rule.blockedDomains << rule.allowedDomains << static_cast<quint16>(rule.ruleOptions) << static_cast<quint16>(rule.ruleExceptions) << static_cast<qint32>(rule.ruleMatch) << static_cast<qint32>(rule.tokenOffset) << rule.isException << rule.needsDomainCheck;
+	}
+
+	stream << ruleSet->tokens << ruleSet->unindexedRules << ruleSet->cosmeticFiltersRules << ruleSet->cosmeticFiltersDomainRules << ruleSet->cosmeticFiltersDomainExceptions;
+
+	file.commit();
 }
 
 void AdblockContentFiltersProfile::setProfileSummary(const ContentFiltersProfile::ProfileSummary &profileSummary)
@@ -678,6 +815,18 @@ QString AdblockContentFiltersProfile::getPath() const
 	return SessionsManager::getWritableDataPath(QLatin1String("contentBlocking/%1.txt")).arg(m_profileSummary.name);
 }
 
+QString AdblockContentFiltersProfile::getCachePath() const
+{
+	return SessionsManager::getWritableDataPath(QLatin1String("contentBlocking/%1.dat")).arg(m_profileSummary.name);
+}
+
+QSharedPointer<AdblockContentFiltersProfile::RuleSet> AdblockContentFiltersProfile::getRuleSet() const
+{
+	QMutexLocker locker(&m_ruleSetMutex);
+
+	return m_ruleSet;
+}
+
 QDateTime AdblockContentFiltersProfile::getLastUpdate() const
 {
 	return m_profileSummary.lastUpdate;
@@ -700,19 +849,31 @@ ContentFiltersManager::CosmeticFiltersResult AdblockContentFiltersProfile::getCo
 		loadRules();
 	}
 
-	ContentFiltersManager::CosmeticFiltersResult result;
+	const QSharedPointer<RuleSet> ruleSet(getRuleSet());
 
-	if (!isDomainOnly)
+	if (!ruleSet)
 	{
-		result.rules = m_cosmeticFiltersRules;
+		return {};
 	}
 
+	ContentFiltersManager::CosmeticFiltersResult result;
+	QStringList domainRules;
+
 	for (int i = 0; i < domains.count(); ++i)
 	{
-		result.rules.append(m_cosmeticFiltersDomainRules.values(domains.at(i)));
-		result.exceptions.append(m_cosmeticFiltersDomainExceptions.values(domains.at(i)));
+		domainRules.append(ruleSet->cosmeticFiltersDomainRules.value(domains.at(i)));
+		result.exceptions.append(ruleSet->cosmeticFiltersDomainExceptions.value(domains.at(i)));
 	}
 
+	if (!isDomainOnly)
+	{
+		result.rules = ruleSet->cosmeticFiltersRules;
+		result.styleSheet = (result.exceptions.isEmpty() ? ruleSet->cosmeticFiltersStyleSheet : ContentFiltersManager::createStyleSheet(ruleSet->cosmeticFiltersRules, result.exceptions));
+	}
+
+	result.rules.append(domainRules);
+	result.styleSheet.append(ContentFiltersManager::createStyleSheet(domainRules, result.exceptions));
+
 	return result;
 }
 
@@ -725,11 +886,25 @@ ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkUrl(const
 		return result;
 	}
 
+	const QSharedPointer<RuleSet> ruleSet(getRuleSet());
+
+	if (!ruleSet)
+	{
+		return result;
+	}
+
 	const Request request(baseUrl, requestUrl, resourceType);
 
-	for (int i = 0; i < request.requestUrl.length(); ++i)
+	for (int i = 0; i <= (request.requestUrl.length() - 4); ++i)
 	{
-		const ContentFiltersManager::CheckResult currentResult(checkUrlSubstring(m_root, request.requestUrl.right(request.requestUrl.length() - i), {}, request));
+		const QHash<quint64, QVector<int> >::const_iterator iterator(ruleSet->tokens.constFind(createTokenKey(request.requestUrl, i)));
+
+		if (iterator == ruleSet->tokens.constEnd())
+		{
+			continue;
+		}
+
+		const ContentFiltersManager::CheckResult currentResult(checkRules(ruleSet.data(), iterator.value(), request, i));
 
 		if (currentResult.isBlocked)
 		{
@@ -741,28 +916,82 @@ ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkUrl(const
 		}
 	}
 
+	const ContentFiltersManager::CheckResult currentResult(checkRules(ruleSet.data(), ruleSet->unindexedRules, request));
+
+	if (currentResult.isBlocked || currentResult.isException)
+	{
+		return currentResult;
+	}
+
 	return result;
 }
 
-ContentFiltersManager::CheckResult AdblockContentFiltersProfile::evaluateNodeRules(const Node *node, const QString &currentRule, const Request &request) const
+ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkUrlMerged(const QVector<int> &profiles, const QUrl &baseUrl, const QUrl &requestUrl, NetworkManager::ResourceType resourceType)
 {
+	QVector<QSharedPointer<RuleSet> > ruleSets;
+	ruleSets.reserve(profiles.count());
+
+	for (int i = 0; i < profiles.count(); ++i)
+	{
+		AdblockContentFiltersProfile *profile(qobject_cast<AdblockContentFiltersProfile*>(ContentFiltersManager::getProfile(profiles.at(i))));
+
+		if (profile && (profile->m_wasLoaded || profile->loadRules()))
+		{
+			ruleSets.append(profile->getRuleSet());
+		}
+		else
+		{
+			ruleSets.append({});
+		}
+	}
+
+	QSharedPointer<MergedRuleSet> mergedRuleSet;
+
+	m_mergedRuleSetsMutex.lock();
+
+	if (m_mergedRuleSets.contains(profiles))
+	{
+		mergedRuleSet = *m_mergedRuleSets.object(profiles);
+	}
+
+	if (!mergedRuleSet || mergedRuleSet->ruleSets != ruleSets)
+	{
+		mergedRuleSet = createMergedRuleSet(profiles, ruleSets);
+
+		m_mergedRuleSets.insert(profiles, new QSharedPointer<MergedRuleSet>(mergedRuleSet));
+	}
+
+	m_mergedRuleSetsMutex.unlock();
+
+	const Request request(baseUrl, requestUrl, resourceType);
 	ContentFiltersManager::CheckResult result;
 
-	for (int i = 0; i < node->rules.count(); ++i)
+	for (int i = 0; i <= (request.requestUrl.length() - 4); ++i)
 	{
-		if (node->rules.at(i))
+		const QHash<quint64, QVector<MergedRuleSet::RuleReference> >::const_iterator iterator(mergedRuleSet->tokens.constFind(createTokenKey(request.requestUrl, i)));
+
+		if (iterator == mergedRuleSet->tokens.constEnd())
 		{
-			ContentFiltersManager::CheckResult currentResult(checkRuleMatch(node->rules.at(i), currentRule, request));
+			continue;
+		}
 
-			if (currentResult.isBlocked)
-			{
-				result = currentResult;
-			}
-			else if (currentResult.isException)
-			{
-				return currentResult;
-			}
+		const ContentFiltersManager::CheckResult currentResult(checkMergedRules(mergedRuleSet.data(), iterator.value(), request, i));
+
+		if (currentResult.isBlocked)
+		{
+			result = currentResult;
 		}
+		else if (currentResult.isException)
+		{
+			return currentResult;
+		}
+	}
+
+	const ContentFiltersManager::CheckResult currentResult(checkMergedRules(mergedRuleSet.data(), mergedRuleSet->unindexedRules, request));
+
+	if (currentResult.isBlocked || currentResult.isException)
+	{
+		return currentResult;
 	}
 
 	return result;
@@ -954,7 +1183,11 @@ bool AdblockContentFiltersProfile::create(const ContentFiltersProfile::ProfileSu
 
 	ContentFiltersManager::addProfile(profile);
 
-	if (!rulesDevice && profileSummary.updateUrl.isValid())
+	if (rulesDevice)
+	{
+		profile->compileRules();
+	}
+	else if (profileSummary.updateUrl.isValid())
 	{
 		profile->update();
 	}
@@ -975,31 +1208,169 @@ bool AdblockContentFiltersProfile::loadRules()
 		return false;
 	}
 
+	QMutexLocker locker(&m_ruleSetMutex);
+
+	if (m_wasLoaded)
+	{
+		return !m_ruleSet.isNull();
+	}
+
 	m_wasLoaded = true;
 
-	if (m_domainExpression.pattern().isEmpty())
+	QSharedPointer<RuleSet> ruleSet(loadRulesCache(m_profileSummary, path, getCachePath()));
+
+	if (!ruleSet)
 	{
-		m_domainExpression = QRegularExpression(QLatin1String("[:\?&/=]"));
-		m_domainExpression.optimize();
+		ruleSet = parseRules(m_profileSummary, path, getCachePath());
 	}
 
+	if (ruleSet)
+	{
+		m_ruleSet = ruleSet;
+
+		return true;
+	}
+
+	locker.unlock();
+
+	if (thread() == QThread::currentThread())
+	{
+		raiseError(QCoreApplication::translate("main", "Failed to open content blocking profile file: %1").arg(path), ReadError);
+	}
+	else
+	{
+		QMetaObject::invokeMethod(this, "compileRules", Qt::QueuedConnection);
+	}
+
+	return false;
+}
+
+QSharedPointer<AdblockContentFiltersProfile::RuleSet> AdblockContentFiltersProfile::loadRulesCache(const ProfileSummary &profileSummary, const QString &path, const QString &cachePath)
+{
+	const QFileInfo rulesInformation(path);
+	QFile file(cachePath);
+
+	if (!rulesInformation.exists() || !file.exists() || !file.open(QIODevice::ReadOnly))
+	{
+		return {};
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_6);
+
+	quint32 magic(0);
+	quint32 version(0);
+	qint64 size(0);
+	qint64 lastModified(0);
+	qint32 cosmeticFiltersMode(0);
+	bool areWildcardsEnabled(false);
+
+	stream >> magic >> version >> size >> lastModified >> cosmeticFiltersMode >> areWildcardsEnabled;
+
+	if (magic != RULES_CACHE_MAGIC || version != RULES_CACHE_VERSION || size != rulesInformation.size() || lastModified != rulesInformation.lastModified().toMSecsSinceEpoch() || cosmeticFiltersMode != profileSummary.cosmeticFiltersMode || areWildcardsEnabled != profileSummary.areWildcardsEnabled)
+	{
+		return {};
+	}
+
+	QSharedPointer<RuleSet> ruleSet(new RuleSet(), &AdblockContentFiltersProfile::deleteRuleSet);
+	quint32 amount(0);
+
+	stream >> amount;
+
+	if (stream.status() != QDataStream::Ok || amount > file.size())
+	{
+		return {};
+	}
+
+	ruleSet->rules.reserve(static_cast<int>(amount));
+
+	for (quint32 i = 0; i < amount; ++i)
+	{
+		Rule rule;
+		quint16 ruleOptions(0);
+		quint16 ruleExceptions(0);
+		qint32 ruleMatch(0);
+		qint32 tokenOffset(-1);
+
+		stream >> rule.rule >> rule.pattern >> rule.blockedDomains >> rule.allowedDomains >> ruleOptions >> ruleExceptions >> ruleMatch >> tokenOffset >> rule.isException >> rule.needsDomainCheck;
+
+		if (stream.status() != QDataStream::Ok)
+		{
+			break;
+		}
+
+		rule.ruleOptions = static_cast<RuleOptions>(ruleOptions);
+		rule.ruleExceptions = static_cast<RuleOptions>(ruleExceptions);
+		rule.ruleMatch = static_cast<RuleMatch>(ruleMatch);
+		rule.tokenOffset = tokenOffset;
+
+		ruleSet->rules.append(rule);
+	}
+
+	stream >> ruleSet->tokens >> ruleSet->unindexedRules >> ruleSet->cosmeticFiltersRules >> ruleSet->cosmeticFiltersDomainRules >> ruleSet->cosmeticFiltersDomainExceptions;
+
+	file.close();
+
+	const int rulesAmount(ruleSet->rules.count());
+
+	if (stream.status() != QDataStream::Ok || rulesAmount != static_cast<int>(amount))
+	{
+		return {};
+	}
+
+	QHash<quint64, QVector<int> >::const_iterator iterator;
+
+	for (iterator = ruleSet->tokens.constBegin(); iterator != ruleSet->tokens.constEnd(); ++iterator)
+	{
+		for (int i = 0; i < iterator.value().count(); ++i)
+		{
+			if (iterator.value().at(i) < 0 || iterator.value().at(i) >= rulesAmount)
+			{
+				return {};
+			}
+		}
+	}
+
+	for (int i = 0; i < ruleSet->unindexedRules.count(); ++i)
+	{
+		if (ruleSet->unindexedRules.at(i) < 0 || ruleSet->unindexedRules.at(i) >= rulesAmount)
+		{
+			return {};
+		}
+	}
+
+	ruleSet->cosmeticFiltersStyleSheet = ContentFiltersManager::createStyleSheet(ruleSet->cosmeticFiltersRules);
+
+	return ruleSet;
+}
+
+QSharedPointer<AdblockContentFiltersProfile::RuleSet> AdblockContentFiltersProfile::parseRules(const ProfileSummary &profileSummary, const QString &path, const QString &cachePath)
+{
 	QFile file(path);
-	file.open(QIODevice::ReadOnly | QIODevice::Text);
 
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+	{
+		return {};
+	}
+
+	QSharedPointer<RuleSet> ruleSet(new RuleSet(), &AdblockContentFiltersProfile::deleteRuleSet);
 	QTextStream stream(&file);
 	stream.setCodec("UTF-8");
 	stream.readLine(); // header
 
-	m_root = new Node();
-
 	while (!stream.atEnd())
 	{
-		parseRuleLine(stream.readLine());
+		parseRuleLine(stream.readLine(), profileSummary, ruleSet.data());
 	}
 
 	file.close();
 
-	return true;
+	createRulesIndex(ruleSet.data());
+	saveRulesCache(ruleSet.data(), profileSummary, path, cachePath);
+
+	ruleSet->cosmeticFiltersStyleSheet = ContentFiltersManager::createStyleSheet(ruleSet->cosmeticFiltersRules);
+
+	return ruleSet;
 }
 
 bool AdblockContentFiltersProfile::update(const QUrl &url)
@@ -1048,6 +1419,8 @@ bool AdblockContentFiltersProfile::remove()
 		m_dataFetchJob = nullptr;
 	}
 
+	QFile::remove(getCachePath());
+
 	if (QFile::exists(path))
 	{
 		return QFile::remove(path);
@@ -1056,7 +1429,62 @@ bool AdblockContentFiltersProfile::remove()
 	return true;
 }
 
-bool AdblockContentFiltersProfile::resolveDomainExceptions(const QString &url, const QStringList &ruleList) const
+bool AdblockContentFiltersProfile::matchPattern(const Rule &rule, int patternPosition, int urlStart, int urlPosition, const Request &request, ContentFiltersManager::CheckResult &result)
+{
+	while (patternPosition < rule.pattern.length())
+	{
+		if (urlPosition >= request.requestUrl.length())
+		{
+			return false;
+		}
+
+		const QChar value(rule.pattern.at(patternPosition));
+
+		if (value == QLatin1Char('*'))
+		{
+			for (int i = urlPosition; i < request.requestUrl.length(); ++i)
+			{
+				if (matchPattern(rule, (patternPosition + 1), urlStart, i, request, result))
+				{
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		if (value == QLatin1Char('^'))
+		{
+			if (!isSeparator(request.requestUrl.at(urlPosition)))
+			{
+				return false;
+			}
+
+			++patternPosition;
+
+			continue;
+		}
+
+		if (value != request.requestUrl.at(urlPosition))
+		{
+			return false;
+		}
+
+		++patternPosition;
+		++urlPosition;
+	}
+
+	result = checkRuleMatch(rule, request.requestUrl.mid(urlStart, (urlPosition - urlStart)), request);
+
+	return (result.isBlocked || result.isException);
+}
+
+bool AdblockContentFiltersProfile::isSeparator(const QChar &character)
+{
+	return (!character.isDigit() && !character.isLetter() && character != QLatin1Char('_') && character != QLatin1Char('-') && character != QLatin1Char('.') && character != QLatin1Char('%'));
+}
+
+bool AdblockContentFiltersProfile::resolveDomainExceptions(const QString &url, const QStringList &ruleList)
 {
 	for (int i = 0; i < ruleList.count(); ++i)
 	{
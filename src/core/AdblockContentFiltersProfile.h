@@ -24,7 +24,11 @@
 
 #include "ContentFiltersManager.h"
 
+#include <QtCore/QCache>
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QMutex>
 #include <QtCore/QRegularExpression>
+#include <QtCore/QSharedPointer>
 
 namespace Otter
 {
@@ -69,6 +73,7 @@ public:
 	ProfileSummary getProfileSummary() const override;
 	ContentFiltersManager::CosmeticFiltersResult getCosmeticFilters(const QStringList &domains, bool isDomainOnly) override;
 	ContentFiltersManager::CheckResult checkUrl(const QUrl &baseUrl, const QUrl &requestUrl, NetworkManager::ResourceType resourceType) override;
+	static ContentFiltersManager::CheckResult checkUrlMerged(const QVector<int> &profiles, const QUrl &baseUrl, const QUrl &requestUrl, NetworkManager::ResourceType resourceType);
 	static HeaderInformation loadHeader(QIODevice *rulesDevice);
 	static QHash<RuleType, quint32> loadRulesInformation(const ProfileSummary &profileSummary, QIODevice *rulesDevice);
 	QVector<QLocale::Language> getLanguages() const override;
@@ -113,23 +118,43 @@ protected:
 		ExactMatch
 	};
 
-	struct Node final
+	struct Rule final
 	{
-		struct Rule final
+		QString rule;
+		QString pattern;
+		QStringList blockedDomains;
+		QStringList allowedDomains;
+		RuleOptions ruleOptions = NoOption;
+		RuleOptions ruleExceptions = NoOption;
+		RuleMatch ruleMatch = ContainsMatch;
+		int tokenOffset = -1;
+		bool isException = false;
+		bool needsDomainCheck = false;
+	};
+
+	struct RuleSet final
+	{
+		QVector<Rule> rules;
+		QHash<quint64, QVector<int> > tokens;
+		QVector<int> unindexedRules;
+		QStringList cosmeticFiltersRules;
+		QHash<QString, QStringList> cosmeticFiltersDomainRules;
+		QHash<QString, QStringList> cosmeticFiltersDomainExceptions;
+		QString cosmeticFiltersStyleSheet;
+	};
+
+	struct MergedRuleSet final
+	{
+		struct RuleReference final
 		{
-			QString rule;
-			QStringList blockedDomains;
-			QStringList allowedDomains;
-			RuleOptions ruleOptions = NoOption;
-			RuleOptions ruleExceptions = NoOption;
-			RuleMatch ruleMatch = ContainsMatch;
-			bool isException = false;
-			bool needsDomainCheck = false;
+			int ruleSet;
+			int rule;
 		};
 
-		QChar value = 0;
-		QVarLengthArray<Node*, 1> children;
-		QVarLengthArray<Rule*, 1> rules;
+		QVector<int> profiles;
+		QVector<QSharedPointer<RuleSet> > ruleSets;
+		QHash<quint64, QVector<RuleReference> > tokens;
+		QVector<RuleReference> unindexedRules;
 	};
 
 	struct Request final
@@ -149,34 +174,48 @@ protected:
 	};
 
 	void loadHeader();
-	void parseRuleLine(const QString &rule);
-	void parseStyleSheetRule(const QStringList &line, QMultiHash<QString, QString> &list);
-	void deleteNode(Node *node) const;
-	ContentFiltersManager::CheckResult checkUrlSubstring(const Node *node, const QString &subString, QString currentRule, const Request &request) const;
-	ContentFiltersManager::CheckResult checkRuleMatch(const Node::Rule *rule, const QString &currentRule, const Request &request) const;
-	ContentFiltersManager::CheckResult evaluateNodeRules(const Node *node, const QString &currentRule, const Request &request) const;
+	static void parseRuleLine(const QString &rule, const ProfileSummary &profileSummary, RuleSet *ruleSet);
+	static void parseStyleSheetRule(const QStringList &line, QHash<QString, QStringList> &list);
+	static void createRulesIndex(RuleSet *ruleSet);
+	static void deleteRuleSet(RuleSet *ruleSet);
+	static void saveRulesCache(const RuleSet *ruleSet, const ProfileSummary &profileSummary, const QString &path, const QString &cachePath);
+	QString getCachePath() const;
+	QSharedPointer<RuleSet> getRuleSet() const;
+	static QSharedPointer<RuleSet> loadRulesCache(const ProfileSummary &profileSummary, const QString &path, const QString &cachePath);
+	static QSharedPointer<RuleSet> parseRules(const ProfileSummary &profileSummary, const QString &path, const QString &cachePath);
+	static QSharedPointer<MergedRuleSet> createMergedRuleSet(const QVector<int> &profiles, const QVector<QSharedPointer<RuleSet> > &ruleSets);
+	static void removeMergedRuleSets(const QSharedPointer<RuleSet> &ruleSet);
+	static quint64 createTokenKey(const QString &text, int position);
+	static ContentFiltersManager::CheckResult checkRules(const RuleSet *ruleSet, const QVector<int> &rules, const Request &request, int tokenPosition = -1);
+	static ContentFiltersManager::CheckResult checkMergedRules(const MergedRuleSet *mergedRuleSet, const QVector<MergedRuleSet::RuleReference> &rules, const Request &request, int tokenPosition = -1);
+	static ContentFiltersManager::CheckResult checkRule(const Rule &rule, const Request &request, int urlStart = -1);
+	static ContentFiltersManager::CheckResult checkRuleMatch(const Rule &rule, const QString &currentRule, const Request &request);
 	bool loadRules();
-	bool resolveDomainExceptions(const QString &url, const QStringList &ruleList) const;
+	static bool matchPattern(const Rule &rule, int patternPosition, int urlStart, int urlPosition, const Request &request, ContentFiltersManager::CheckResult &result);
+	static bool isSeparator(const QChar &character);
+	static bool resolveDomainExceptions(const QString &url, const QStringList &ruleList);
 
 protected slots:
+	void compileRules();
 	void raiseError(const QString &message, ProfileError error);
 	void handleJobFinished(bool isSuccess);
 
 private:
-	Node *m_root;
 	DataFetchJob *m_dataFetchJob;
+	QFutureWatcher<QSharedPointer<RuleSet> > *m_ruleSetWatcher;
 	ProfileSummary m_profileSummary;
-	QRegularExpression m_domainExpression;
-	QStringList m_cosmeticFiltersRules;
+	QSharedPointer<RuleSet> m_ruleSet;
 	QVector<QLocale::Language> m_languages;
-	QMultiHash<QString, QString> m_cosmeticFiltersDomainRules;
-	QMultiHash<QString, QString> m_cosmeticFiltersDomainExceptions;
+	mutable QMutex m_ruleSetMutex;
 	ProfileError m_error;
 	ProfileFlags m_flags;
 	bool m_wasLoaded;
 
+	static QRegularExpression m_domainExpression;
 	static QHash<QString, RuleOption> m_options;
 	static QHash<NetworkManager::ResourceType, RuleOption> m_resourceTypes;
+	static QCache<QVector<int>, QSharedPointer<MergedRuleSet> > m_mergedRuleSets;
+	static QMutex m_mergedRuleSetsMutex;
 };
 
 }
@@ -36,6 +36,7 @@
 #include "SearchEnginesManager.h"
 #include "SettingsManager.h"
 #include "SpellCheckManager.h"
+#include "TabSuspensionManager.h"
 #include "TasksManager.h"
 #include "ToolBarsManager.h"
 #include "ThemesManager.h"
@@ -437,6 +438,8 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv),
 
 	SpellCheckManager::createInstance();
 
+	TabSuspensionManager::createInstance();
+
 	ToolBarsManager::createInstance();
 
 	TransfersManager::createInstance();
@@ -30,6 +30,7 @@
 #include <QtCore/QFile>
 #include <QtCore/QMimeData>
 #include <QtCore/QSaveFile>
+#include <QtCore/QSet>
 #include <QtWidgets/QMessageBox>
 
 namespace Otter
@@ -867,6 +868,7 @@ void BookmarksModel::removeBookmarkUrl(Bookmark *bookmark)
 					if (m_urls[url].isEmpty())
 					{
 						m_urls.remove(url);
+						m_completionIndex.removeUrl(url);
 					}
 				}
 			}
@@ -896,6 +898,8 @@ void BookmarksModel::readdBookmarkUrl(Bookmark *bookmark)
 					if (!m_urls.contains(url))
 					{
 						m_urls[url] = {};
+
+						m_completionIndex.addUrl(url);
 					}
 
 					m_urls[url].append(bookmark);
@@ -1022,6 +1026,7 @@ void BookmarksModel::handleUrlChanged(Bookmark *bookmark, const QUrl &newUrl, co
 		if (m_urls[oldUrl].isEmpty())
 		{
 			m_urls.remove(oldUrl);
+			m_completionIndex.removeUrl(oldUrl);
 		}
 	}
 
@@ -1030,6 +1035,8 @@ void BookmarksModel::handleUrlChanged(Bookmark *bookmark, const QUrl &newUrl, co
 		if (!m_urls.contains(newUrl))
 		{
 			m_urls[newUrl] = {};
+
+			m_completionIndex.addUrl(newUrl);
 		}
 
 		m_urls[newUrl].append(bookmark);
@@ -1262,10 +1269,8 @@ QStringList BookmarksModel::getKeywords() const
 
 QVector<BookmarksModel::BookmarkMatch> BookmarksModel::findBookmarks(const QString &prefix) const
 {
-	QVector<Bookmark*> matchedBookmarks;
-	QVector<BookmarkMatch> allMatches;
-	QVector<BookmarkMatch> currentMatches;
-	QMultiMap<QDateTime, BookmarkMatch> matchesMap;
+	QSet<Bookmark*> matchedBookmarks;
+	QVector<BookmarkMatch> keywordMatches;
 	QHash<QString, Bookmark*>::const_iterator keywordsIterator;
 
 	for (keywordsIterator = m_keywords.constBegin(); keywordsIterator != m_keywords.constEnd(); ++keywordsIterator)
@@ -1276,56 +1281,47 @@ QVector<BookmarksModel::BookmarkMatch> BookmarksModel::findBookmarks(const QStri
 			match.bookmark = keywordsIterator.value();
 			match.match = keywordsIterator.key();
 
-			matchesMap.insert(match.bookmark->getTimeVisited(), match);
+			keywordMatches.append(match);
 
-			matchedBookmarks.append(match.bookmark);
+			matchedBookmarks.insert(match.bookmark);
 		}
 	}
 
-	currentMatches = matchesMap.values().toVector();
-
-	matchesMap.clear();
+	const QVector<QUrl> urls(m_completionIndex.findUrls(prefix));
+	QVector<BookmarkMatch> urlMatches;
+	urlMatches.reserve(urls.count());
 
-	allMatches.reserve(currentMatches.count());
-
-	for (int i = (currentMatches.count() - 1); i >= 0; --i)
+	for (int i = 0; i < urls.count(); ++i)
 	{
-		allMatches.append(currentMatches.at(i));
-	}
-
-	QHash<QUrl, QVector<Bookmark*> >::const_iterator urlsIterator;
+		Bookmark *bookmark(m_urls.value(urls.at(i)).value(0));
 
-	for (urlsIterator = m_urls.constBegin(); urlsIterator != m_urls.constEnd(); ++urlsIterator)
-	{
-		if (urlsIterator.value().isEmpty() || matchedBookmarks.contains(urlsIterator.value().value(0)))
+		if (!bookmark || matchedBookmarks.contains(bookmark))
 		{
 			continue;
 		}
 
-		const QString result(Utils::matchUrl(urlsIterator.key(), prefix));
+		const QString result(Utils::matchUrl(urls.at(i), prefix));
 
 		if (!result.isEmpty())
 		{
 			BookmarkMatch match;
-			match.bookmark = urlsIterator.value().value(0);
+			match.bookmark = bookmark;
 			match.match = result;
 
-			matchesMap.insert(match.bookmark->getTimeVisited(), match);
-
-			matchedBookmarks.append(match.bookmark);
+			urlMatches.append(match);
 		}
 	}
 
-	currentMatches = matchesMap.values().toVector();
-
-	matchesMap.clear();
-
-	for (int i = (currentMatches.count() - 1); i >= 0; --i)
+	std::stable_sort(keywordMatches.begin(), keywordMatches.end(), [&](const BookmarkMatch &first, const BookmarkMatch &second)
 	{
-		allMatches.append(currentMatches.at(i));
-	}
+		return (first.bookmark->getTimeVisited() > second.bookmark->getTimeVisited());
+	});
+	std::stable_sort(urlMatches.begin(), urlMatches.end(), [&](const BookmarkMatch &first, const BookmarkMatch &second)
+	{
+		return (first.bookmark->getTimeVisited() > second.bookmark->getTimeVisited());
+	});
 
-	return allMatches;
+	return (keywordMatches + urlMatches);
 }
 
 QVector<BookmarksModel::Bookmark*> BookmarksModel::findUrls(const QUrl &url, QStandardItem *branch) const
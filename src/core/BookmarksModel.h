@@ -21,6 +21,8 @@
 #ifndef OTTER_BOOKMARKSMODEL_H
 #define OTTER_BOOKMARKSMODEL_H
 
+#include "CompletionIndex.h"
+
 #include <QtCore/QUrl>
 #include <QtCore/QXmlStreamReader>
 #include <QtCore/QXmlStreamWriter>
@@ -163,6 +165,7 @@ private:
 	QHash<QUrl, QVector<Bookmark*> > m_urls;
 	QHash<QString, Bookmark*> m_keywords;
 	QMap<quint64, Bookmark*> m_identifiers;
+	CompletionIndex m_completionIndex;
 	FormatMode m_mode;
 
 signals:
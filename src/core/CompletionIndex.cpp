@@ -0,0 +1,191 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "CompletionIndex.h"
+
+namespace Otter
+{
+
+void CompletionIndex::addUrl(const QUrl &url)
+{
+	if (m_removedUrls.contains(url))
+	{
+		removePendingUrls();
+	}
+
+	m_pendingKeys.append(createKeys(url));
+}
+
+void CompletionIndex::addUrls(const QVector<QUrl> &urls)
+{
+	if (!m_removedUrls.isEmpty())
+	{
+		removePendingUrls();
+	}
+
+	m_pendingKeys.reserve(m_pendingKeys.count() + (urls.count() * 3));
+
+	for (int i = 0; i < urls.count(); ++i)
+	{
+		m_pendingKeys.append(createKeys(urls.at(i)));
+	}
+}
+
+void CompletionIndex::removeUrl(const QUrl &url)
+{
+	m_removedUrls.insert(url);
+}
+
+void CompletionIndex::clear()
+{
+	m_keys.clear();
+	m_pendingKeys.clear();
+	m_removedUrls.clear();
+}
+
+void CompletionIndex::removePendingUrls() const
+{
+	if (m_removedUrls.isEmpty())
+	{
+		return;
+	}
+
+	m_keys.erase(std::remove_if(m_keys.begin(), m_keys.end(), [&](const Key &key)
+	{
+		return m_removedUrls.contains(key.url);
+	}), m_keys.end());
+	m_pendingKeys.erase(std::remove_if(m_pendingKeys.begin(), m_pendingKeys.end(), [&](const Key &key)
+	{
+		return m_removedUrls.contains(key.url);
+	}), m_pendingKeys.end());
+
+	m_removedUrls.clear();
+}
+
+void CompletionIndex::mergePendingKeys() const
+{
+	removePendingUrls();
+
+	if (m_pendingKeys.isEmpty())
+	{
+		return;
+	}
+
+	const int amount(m_keys.count());
+
+	std::stable_sort(m_pendingKeys.begin(), m_pendingKeys.end(), isLessThan);
+
+	m_keys.append(m_pendingKeys);
+
+	m_pendingKeys.clear();
+
+	std::inplace_merge(m_keys.begin(), (m_keys.begin() + amount), m_keys.end(), isLessThan);
+}
+
+QVector<QUrl> CompletionIndex::findUrls(const QString &prefix) const
+{
+	const QString normalizedPrefix(prefix.toLower());
+	const QVector<Key>::const_iterator end(getUpperBound(normalizedPrefix));
+	QVector<QUrl> urls;
+	QSet<QUrl> matchedUrls;
+
+	for (QVector<Key>::const_iterator iterator(getLowerBound(normalizedPrefix)); iterator != end; ++iterator)
+	{
+		if (!matchedUrls.contains(iterator->url))
+		{
+			matchedUrls.insert(iterator->url);
+
+			urls.append(iterator->url);
+		}
+	}
+
+	return urls;
+}
+
+QVector<CompletionIndex::Key>::const_iterator CompletionIndex::getLowerBound(const QString &prefix) const
+{
+	mergePendingKeys();
+
+	return std::lower_bound(m_keys.constBegin(), m_keys.constEnd(), prefix, [&](const Key &key, const QString &value)
+	{
+		return (key.getKey().compare(value) < 0);
+	});
+}
+
+QVector<CompletionIndex::Key>::const_iterator CompletionIndex::getUpperBound(const QString &prefix) const
+{
+	mergePendingKeys();
+
+	return std::upper_bound(m_keys.constBegin(), m_keys.constEnd(), prefix, [&](const QString &value, const Key &key)
+	{
+		return (key.getKey().left(value.length()).compare(value) > 0);
+	});
+}
+
+QVector<CompletionIndex::Key> CompletionIndex::createKeys(const QUrl &url)
+{
+	QVector<Key> keys;
+	keys.reserve(3);
+
+	const QString text(url.toString().toLower());
+
+	keys.append({text, url, 0});
+
+	QString match(url.toString(QUrl::RemoveScheme).mid(2));
+
+	for (int i = 0; i < 2; ++i)
+	{
+		const QString key(match.toLower());
+
+		if (key != text)
+		{
+			if (text.endsWith(key))
+			{
+				keys.append({text, url, (text.length() - key.length())});
+			}
+			else
+			{
+				keys.append({key, url, 0});
+			}
+		}
+
+		if (!match.startsWith(QLatin1String("www.")) || url.host().count(QLatin1Char('.')) < 2)
+		{
+			break;
+		}
+
+		match = match.mid(4);
+	}
+
+	return keys;
+}
+
+int CompletionIndex::getMatchesAmount(const QString &prefix) const
+{
+	const QString normalizedPrefix(prefix.toLower());
+
+	return static_cast<int>(getUpperBound(normalizedPrefix) - getLowerBound(normalizedPrefix));
+}
+
+bool CompletionIndex::isLessThan(const Key &first, const Key &second)
+{
+	return (first.getKey().compare(second.getKey()) < 0);
+}
+
+}
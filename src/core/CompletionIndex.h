@@ -0,0 +1,70 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_COMPLETIONINDEX_H
+#define OTTER_COMPLETIONINDEX_H
+
+#include <QtCore/QSet>
+#include <QtCore/QUrl>
+#include <QtCore/QVector>
+
+namespace Otter
+{
+
+class CompletionIndex final
+{
+public:
+	struct Key final
+	{
+		QString text;
+		QUrl url;
+		int offset;
+
+		QStringRef getKey() const
+		{
+			return text.midRef(offset);
+		}
+	};
+
+	void addUrl(const QUrl &url);
+	void addUrls(const QVector<QUrl> &urls);
+	void removeUrl(const QUrl &url);
+	void clear();
+	QVector<QUrl> findUrls(const QString &prefix) const;
+	int getMatchesAmount(const QString &prefix) const;
+
+protected:
+	void removePendingUrls() const;
+	void mergePendingKeys() const;
+	QVector<Key>::const_iterator getLowerBound(const QString &prefix) const;
+	QVector<Key>::const_iterator getUpperBound(const QString &prefix) const;
+	static QVector<Key> createKeys(const QUrl &url);
+	static bool isLessThan(const Key &first, const Key &second);
+
+private:
+	mutable QVector<Key> m_keys;
+	mutable QVector<Key> m_pendingKeys;
+	mutable QSet<QUrl> m_removedUrls;
+};
+
+}
+
+Q_DECLARE_TYPEINFO(Otter::CompletionIndex::Key, Q_MOVABLE_TYPE);
+
+#endif
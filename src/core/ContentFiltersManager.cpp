@@ -37,10 +37,20 @@ namespace Otter
 ContentFiltersManager* ContentFiltersManager::m_instance(nullptr);
 QVector<ContentFiltersProfile*> ContentFiltersManager::m_contentBlockingProfiles;
 QVector<ContentFiltersProfile*> ContentFiltersManager::m_fraudCheckingProfiles;
+QCache<QString, ContentFiltersManager::CheckResult> ContentFiltersManager::m_checkCache(1000);
+QCache<QString, ContentFiltersManager::CosmeticFiltersResult> ContentFiltersManager::m_cosmeticFiltersCache(100);
+QMutex ContentFiltersManager::m_cachesMutex;
+ContentFiltersManager::CheckCacheStatistics ContentFiltersManager::m_checkCacheStatistics;
+quint64 ContentFiltersManager::m_cachesGeneration(0);
+bool ContentFiltersManager::m_isMergedEvaluationEnabled(true);
 
 ContentFiltersManager::ContentFiltersManager(QObject *parent) : QObject(parent),
 	m_saveTimer(0)
 {
+	m_isMergedEvaluationEnabled = SettingsManager::getOption(SettingsManager::ContentBlocking_EnableMergedEvaluationOption).toBool();
+
+	connect(SettingsManager::getInstance(), &SettingsManager::optionChanged, this, &ContentFiltersManager::handleOptionChanged);
+
 	QTimer::singleShot(1000, this, [&]()
 	{
 		initialize();
@@ -172,6 +182,8 @@ void ContentFiltersManager::initialize()
 
 		connect(profile, &ContentFiltersProfile::profileModified, profile, [=]()
 		{
+			clearCaches();
+
 			m_instance->scheduleSave();
 
 			emit m_instance->profileModified(profile->getName());
@@ -212,6 +224,16 @@ void ContentFiltersManager::scheduleSave()
 	}
 }
 
+void ContentFiltersManager::handleOptionChanged(int identifier, const QVariant &value)
+{
+	if (identifier == SettingsManager::ContentBlocking_EnableMergedEvaluationOption)
+	{
+		m_isMergedEvaluationEnabled = value.toBool();
+
+		clearCaches();
+	}
+}
+
 void ContentFiltersManager::save()
 {
 	const QHash<ContentFiltersProfile::ProfileCategory, QString> categories({{ContentFiltersProfile::AdvertisementsCategory, QLatin1String("advertisements")}, {ContentFiltersProfile::AnnoyanceCategory, QLatin1String("annoyance")}, {ContentFiltersProfile::PrivacyCategory, QLatin1String("privacy")}, {ContentFiltersProfile::SocialCategory, QLatin1String("social")}, {ContentFiltersProfile::RegionalCategory, QLatin1String("regional")}, {ContentFiltersProfile::OtherCategory, QLatin1String("other")}});
@@ -289,6 +311,16 @@ void ContentFiltersManager::save()
 	settings.save();
 }
 
+void ContentFiltersManager::clearCaches()
+{
+	QMutexLocker locker(&m_cachesMutex);
+
+	m_checkCache.clear();
+	m_cosmeticFiltersCache.clear();
+
+	++m_cachesGeneration;
+}
+
 void ContentFiltersManager::addProfile(ContentFiltersProfile *profile)
 {
 	if (!profile)
@@ -296,6 +328,8 @@ void ContentFiltersManager::addProfile(ContentFiltersProfile *profile)
 		return;
 	}
 
+	clearCaches();
+
 	bool isReplacing(false);
 
 	for (int i = 0; i < m_contentBlockingProfiles.count(); ++i)
@@ -354,6 +388,8 @@ void ContentFiltersManager::removeProfile(ContentFiltersProfile *profile, bool r
 
 	m_contentBlockingProfiles.removeAll(profile);
 
+	clearCaches();
+
 	profile->deleteLater();
 
 	emit m_instance->profileRemoved(name);
@@ -414,28 +450,77 @@ ContentFiltersManager::CheckResult ContentFiltersManager::checkUrl(const QVector
 		return {};
 	}
 
+	QString cacheKey(QString::number(resourceType));
+
+	for (int i = 0; i < profiles.count(); ++i)
+	{
+		cacheKey.append(QLatin1Char(',') + QString::number(profiles.at(i)));
+	}
+
+	cacheKey.append(QLatin1Char(' ') + baseUrl.host() + QLatin1Char(' ') + requestUrl.toString());
+
+	m_cachesMutex.lock();
+
+	const CheckResult *cachedResult(m_checkCache.object(cacheKey));
+
+	if (cachedResult)
+	{
+		const CheckResult result(*cachedResult);
+
+		++m_checkCacheStatistics.hits;
+
+		m_cachesMutex.unlock();
+
+		return result;
+	}
+
+	++m_checkCacheStatistics.misses;
+
+	const quint64 generation(m_cachesGeneration);
+
+	m_cachesMutex.unlock();
+
 	CheckResult result;
 	result.isFraud = ((resourceType == NetworkManager::MainFrameType || resourceType == NetworkManager::SubFrameType) ? isFraud(requestUrl) : false);
 
-	for (int i = 0; i < profiles.count(); ++i)
+	if (m_isMergedEvaluationEnabled)
 	{
-		if (profiles.at(i) >= 0 && profiles.at(i) < m_contentBlockingProfiles.count())
-		{
-			CheckResult currentResult(m_contentBlockingProfiles.at(profiles.at(i))->checkUrl(baseUrl, requestUrl, resourceType));
-			currentResult.profile = profiles.at(i);
-			currentResult.isFraud = result.isFraud;
+		const bool isFraudulent(result.isFraud);
 
-			if (currentResult.isBlocked)
-			{
-				result = currentResult;
-			}
-			else if (currentResult.isException)
+		result = AdblockContentFiltersProfile::checkUrlMerged(profiles, baseUrl, requestUrl, resourceType);
+		result.isFraud = isFraudulent;
+	}
+	else
+	{
+		for (int i = 0; i < profiles.count(); ++i)
+		{
+			if (profiles.at(i) >= 0 && profiles.at(i) < m_contentBlockingProfiles.count())
 			{
-				return currentResult;
+				CheckResult currentResult(m_contentBlockingProfiles.at(profiles.at(i))->checkUrl(baseUrl, requestUrl, resourceType));
+				currentResult.profile = profiles.at(i);
+				currentResult.isFraud = result.isFraud;
+
+				if (currentResult.isBlocked)
+				{
+					result = currentResult;
+				}
+				else if (currentResult.isException)
+				{
+					result = currentResult;
+
+					break;
+				}
 			}
 		}
 	}
 
+	QMutexLocker locker(&m_cachesMutex);
+
+	if (generation == m_cachesGeneration)
+	{
+		m_checkCache.insert(cacheKey, new CheckResult(result));
+	}
+
 	return result;
 }
 
@@ -453,6 +538,32 @@ ContentFiltersManager::CosmeticFiltersResult ContentFiltersManager::getCosmeticF
 		return {};
 	}
 
+	QString cacheKey(QString::number(mode));
+
+	for (int i = 0; i < profiles.count(); ++i)
+	{
+		cacheKey.append(QLatin1Char(',') + QString::number(profiles.at(i)));
+	}
+
+	cacheKey.append(QLatin1Char(' ') + requestUrl.host());
+
+	m_cachesMutex.lock();
+
+	const CosmeticFiltersResult *cachedResult(m_cosmeticFiltersCache.object(cacheKey));
+
+	if (cachedResult)
+	{
+		const CosmeticFiltersResult result(*cachedResult);
+
+		m_cachesMutex.unlock();
+
+		return result;
+	}
+
+	const quint64 generation(m_cachesGeneration);
+
+	m_cachesMutex.unlock();
+
 	CosmeticFiltersResult result;
 	const QStringList domains(createSubdomainList(requestUrl.host()));
 
@@ -464,14 +575,42 @@ ContentFiltersManager::CosmeticFiltersResult ContentFiltersManager::getCosmeticF
 		{
 			const CosmeticFiltersResult profileResult(m_contentBlockingProfiles.at(index)->getCosmeticFilters(domains, (mode == DomainOnlyFilters)));
 
+			result.styleSheet.append(profileResult.styleSheet);
 			result.rules.append(profileResult.rules);
 			result.exceptions.append(profileResult.exceptions);
 		}
 	}
 
+	if (profiles.count() > 1 && !result.exceptions.isEmpty())
+	{
+		result.styleSheet = createStyleSheet(result.rules, result.exceptions);
+	}
+
+	QMutexLocker locker(&m_cachesMutex);
+
+	if (generation == m_cachesGeneration)
+	{
+		m_cosmeticFiltersCache.insert(cacheKey, new CosmeticFiltersResult(result));
+	}
+
 	return result;
 }
 
+QString ContentFiltersManager::createStyleSheet(const QStringList &selectors, const QStringList &exceptions)
+{
+	QString styleSheet;
+
+	for (int i = 0; i < selectors.count(); ++i)
+	{
+		if (!exceptions.contains(selectors.at(i)))
+		{
+			styleSheet.append(selectors.at(i) + QLatin1String("{display:none !important}\n"));
+		}
+	}
+
+	return styleSheet;
+}
+
 QStringList ContentFiltersManager::createSubdomainList(const QString &domain)
 {
 	QStringList subdomainList;
@@ -490,6 +629,13 @@ QStringList ContentFiltersManager::createSubdomainList(const QString &domain)
 	return subdomainList;
 }
 
+ContentFiltersManager::CheckCacheStatistics ContentFiltersManager::getCacheStatistics()
+{
+	QMutexLocker locker(&m_cachesMutex);
+
+	return m_checkCacheStatistics;
+}
+
 QStringList ContentFiltersManager::getProfileNames()
 {
 	initialize();
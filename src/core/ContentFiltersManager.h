@@ -23,6 +23,8 @@
 
 #include "NetworkManager.h"
 
+#include <QtCore/QCache>
+#include <QtCore/QMutex>
 #include <QtCore/QUrl>
 
 namespace Otter
@@ -54,20 +56,30 @@ public:
 
 	struct CosmeticFiltersResult final
 	{
+		QString styleSheet;
 		QStringList rules;
 		QStringList exceptions;
 	};
 
+	struct CheckCacheStatistics final
+	{
+		quint64 hits = 0;
+		quint64 misses = 0;
+	};
+
 	static void createInstance();
 	static void initialize();
 	static void addProfile(ContentFiltersProfile *profile);
 	static void removeProfile(ContentFiltersProfile *profile, bool removeFile = false);
+	static void clearCaches();
 	static ContentFiltersManager* getInstance();
 	static ContentFiltersProfile* getProfile(const QString &profile);
 	static ContentFiltersProfile* getProfile(const QUrl &url);
 	static ContentFiltersProfile* getProfile(int identifier);
 	static CheckResult checkUrl(const QVector<int> &profiles, const QUrl &baseUrl, const QUrl &requestUrl, NetworkManager::ResourceType resourceType);
 	static CosmeticFiltersResult getCosmeticFilters(const QVector<int> &profiles, const QUrl &requestUrl);
+	static CheckCacheStatistics getCacheStatistics();
+	static QString createStyleSheet(const QStringList &selectors, const QStringList &exceptions = {});
 	static QStringList createSubdomainList(const QString &domain);
 	static QStringList getProfileNames();
 	static QVector<ContentFiltersProfile*> getContentBlockingProfiles();
@@ -83,6 +95,7 @@ protected:
 
 protected slots:
 	void scheduleSave();
+	void handleOptionChanged(int identifier, const QVariant &value);
 
 private:
 	int m_saveTimer;
@@ -90,6 +103,12 @@ private:
 	static ContentFiltersManager *m_instance;
 	static QVector<ContentFiltersProfile*> m_contentBlockingProfiles;
 	static QVector<ContentFiltersProfile*> m_fraudCheckingProfiles;
+	static QCache<QString, CheckResult> m_checkCache;
+	static QCache<QString, CosmeticFiltersResult> m_cosmeticFiltersCache;
+	static QMutex m_cachesMutex;
+	static CheckCacheStatistics m_checkCacheStatistics;
+	static quint64 m_cachesGeneration;
+	static bool m_isMergedEvaluationEnabled;
 
 signals:
 	void profileAdded(const QString &profile);
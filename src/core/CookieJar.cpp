@@ -27,6 +27,10 @@
 #include <QtCore/QSaveFile>
 #include <QtCore/QTimerEvent>
 
+#define COOKIES_JOURNAL_LIMIT 1000
+#define COOKIES_MAGIC 0x4F434B4A
+#define COOKIES_VERSION 1
+
 namespace Otter
 {
 
@@ -35,49 +39,18 @@ CookieJar::CookieJar(const QString &path, QObject *parent) : QNetworkCookieJar(p
 	m_generalCookiesPolicy(AcceptAllCookies),
 	m_thirdPartyCookiesPolicy(AcceptAllCookies),
 	m_keepMode(KeepUntilExpiresMode),
-	m_saveTimer(0)
+	m_journalRecordsAmount(0),
+	m_saveTimer(0),
+	m_needsCompaction(false)
 {
 	if (path.isEmpty())
 	{
 		return;
 	}
 
-	QFile file(path);
-
-	if (!file.open(QIODevice::ReadOnly))
-	{
-		return;
-	}
-
-	QDataStream stream(&file);
-	quint32 amount;
-
-	stream >> amount;
-
-	QList<QNetworkCookie> allCookies;
-	allCookies.reserve(static_cast<int>(amount));
-
-	for (quint32 i = 0; i < amount; ++i)
-	{
-		QByteArray value;
-
-		stream >> value;
-
-		const QList<QNetworkCookie> cookies(QNetworkCookie::parseCookies(value));
-
-		for (int j = 0; j < cookies.count(); ++j)
-		{
-			allCookies.append(cookies.at(j));
-		}
-
-		if (stream.atEnd())
-		{
-			break;
-		}
-	}
-
+	readRecords(path, false);
+	readRecords(getJournalPath(), true);
 	handleOptionChanged(SettingsManager::Network_CookiesPolicyOption, SettingsManager::getOption(SettingsManager::Network_CookiesPolicyOption));
-	setAllCookies(allCookies);
 
 	connect(SettingsManager::getInstance(), &SettingsManager::optionChanged, this, &CookieJar::handleOptionChanged);
 }
@@ -100,13 +73,22 @@ void CookieJar::clearCookies(int period)
 {
 	Q_UNUSED(period)
 
-	const QList<QNetworkCookie> cookies(allCookies());
+	loadAllCookies();
 
-	setAllCookies({});
+	const QHash<QString, QVector<QNetworkCookie> > cookies(m_cookies);
+	QHash<QString, QVector<QNetworkCookie> >::const_iterator iterator;
 
-	for (int i = 0; i < cookies.count(); ++i)
+	m_cookies.clear();
+	m_pendingRecords.clear();
+
+	m_needsCompaction = true;
+
+	for (iterator = cookies.constBegin(); iterator != cookies.constEnd(); ++iterator)
 	{
-		emit cookieRemoved(cookies.at(i));
+		for (int i = 0; i < iterator.value().count(); ++i)
+		{
+			emit cookieRemoved(iterator.value().at(i));
+		}
 	}
 
 	scheduleSave();
@@ -176,26 +158,226 @@ void CookieJar::save()
 		return;
 	}
 
-	QSaveFile file(m_path);
+	if (m_needsCompaction || (m_journalRecordsAmount + m_pendingRecords.count()) >= qMax(COOKIES_JOURNAL_LIMIT, (m_cookies.count() + m_locations.count())))
+	{
+		writeCookies();
 
-	if (!file.open(QIODevice::WriteOnly))
+		return;
+	}
+
+	if (m_pendingRecords.isEmpty())
+	{
+		return;
+	}
+
+	QFile file(getJournalPath());
+	const bool isNew(file.size() == 0);
+
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Append))
 	{
 		return;
 	}
 
-	const QList<QNetworkCookie> cookies(allCookies());
 	QDataStream stream(&file);
-	stream << static_cast<quint32>(cookies.count());
+	stream.setVersion(QDataStream::Qt_5_6);
 
-	for (int i = 0; i < cookies.count(); ++i)
+	if (isNew)
+	{
+		stream << static_cast<quint32>(COOKIES_MAGIC) << static_cast<quint32>(COOKIES_VERSION);
+	}
+
+	for (int i = 0; i < m_pendingRecords.count(); ++i)
+	{
+		const QNetworkCookie cookie(m_pendingRecords.at(i).cookie);
+
+		stream << static_cast<quint8>(m_pendingRecords.at(i).operation) << getGroup(cookie.domain()) << cookie.toRawForm();
+	}
+
+	m_journalRecordsAmount += m_pendingRecords.count();
+
+	m_pendingRecords.clear();
+}
+
+void CookieJar::readRecords(const QString &path, bool isJournal)
+{
+	QFile file(path);
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_6);
+
+	quint32 magic(0);
+	quint32 version(0);
+
+	stream >> magic >> version;
+
+	if (magic != COOKIES_MAGIC || version != COOKIES_VERSION)
+	{
+		if (isJournal)
+		{
+			return;
+		}
+
+		file.seek(0);
+
+		quint32 amount(0);
+
+		stream >> amount;
+
+		for (quint32 i = 0; i < amount; ++i)
+		{
+			QByteArray value;
+
+			stream >> value;
+
+			const QList<QNetworkCookie> cookies(QNetworkCookie::parseCookies(value));
+
+			for (int j = 0; j < cookies.count(); ++j)
+			{
+				storeCookie(cookies.at(j));
+			}
+
+			if (stream.atEnd())
+			{
+				break;
+			}
+		}
+
+		m_needsCompaction = true;
+
+		return;
+	}
+
+	qint64 offset(file.pos());
+
+	while (!stream.atEnd())
+	{
+		quint8 operation(0);
+		quint32 length(0);
+		QString group;
+
+		stream >> operation >> group >> length;
+
+		if (stream.status() != QDataStream::Ok || (length != 0xFFFFFFFF && stream.skipRawData(static_cast<int>(length)) != static_cast<int>(length)))
+		{
+			if (isJournal)
+			{
+				file.close();
+
+				QFile::resize(path, offset);
+			}
+
+			break;
+		}
+
+		m_locations[group].append({offset, isJournal});
+
+		if (isJournal)
+		{
+			++m_journalRecordsAmount;
+		}
+
+		offset = file.pos();
+	}
+}
+
+void CookieJar::loadCookies(const QString &group) const
+{
+	if (!m_locations.contains(group))
+	{
+		return;
+	}
+
+	const QVector<RecordLocation> locations(m_locations.take(group));
+	QFile file(m_path);
+	file.open(QIODevice::ReadOnly);
+
+	QFile journalFile(getJournalPath());
+	journalFile.open(QIODevice::ReadOnly);
+
+	for (int i = 0; i < locations.count(); ++i)
 	{
-		if (!cookies.at(i).isSessionCookie())
+		QFile *device(locations.at(i).isJournal ? &journalFile : &file);
+
+		if (!device->isOpen() || !device->seek(locations.at(i).offset))
+		{
+			continue;
+		}
+
+		QDataStream stream(device);
+		stream.setVersion(QDataStream::Qt_5_6);
+
+		quint8 operation(0);
+		QString recordGroup;
+		QByteArray value;
+
+		stream >> operation >> recordGroup >> value;
+
+		const QList<QNetworkCookie> cookies(QNetworkCookie::parseCookies(value));
+
+		if (stream.status() != QDataStream::Ok || cookies.isEmpty())
+		{
+			continue;
+		}
+
+		if (static_cast<CookieOperation>(operation) == RemoveCookie)
 		{
-			stream << cookies.at(i).toRawForm();
+			removeCookie(cookies.at(0));
+		}
+		else
+		{
+			storeCookie(cookies.at(0));
 		}
 	}
+}
+
+void CookieJar::loadAllCookies() const
+{
+	const QStringList groups(m_locations.keys());
+
+	for (int i = 0; i < groups.count(); ++i)
+	{
+		loadCookies(groups.at(i));
+	}
+}
 
-	file.commit();
+void CookieJar::addRecord(CookieOperation operation, const QNetworkCookie &cookie)
+{
+	m_pendingRecords.append({cookie, operation});
+
+	scheduleSave();
+}
+
+QString CookieJar::getGroup(const QString &domain)
+{
+	QString host(domain.toLower());
+
+	if (host.startsWith(QLatin1Char('.')))
+	{
+		host.remove(0, 1);
+	}
+
+	QUrl url;
+	url.setScheme(QLatin1String("http"));
+	url.setHost(host);
+
+	const QString topLevelDomain(url.topLevelDomain());
+
+	if (topLevelDomain.isEmpty() || topLevelDomain.length() >= host.length())
+	{
+		return host;
+	}
+
+	return host.left(host.length() - topLevelDomain.length()).section(QLatin1Char('.'), -1) + topLevelDomain;
+}
+
+QString CookieJar::getJournalPath() const
+{
+	return m_path + QLatin1String(".journal");
 }
 
 QString CookieJar::getPath() const
@@ -210,19 +392,71 @@ QList<QNetworkCookie> CookieJar::cookiesForUrl(const QUrl &url) const
 		return {};
 	}
 
-	return QNetworkCookieJar::cookiesForUrl(url);
+	return getCookiesForUrl(url);
 }
 
 QList<QNetworkCookie> CookieJar::getCookiesForUrl(const QUrl &url) const
 {
-	return QNetworkCookieJar::cookiesForUrl(url);
+	const QString host(url.host());
+
+	if (host.isEmpty())
+	{
+		return {};
+	}
+
+	const QString group(getGroup(host));
+
+	loadCookies(group);
+
+	const QVector<QNetworkCookie> cookies(m_cookies.value(group));
+	const QDateTime currentDateTime(QDateTime::currentDateTimeUtc());
+	const QString path(url.path());
+	const bool isSecure(url.scheme() == QLatin1String("https") || url.scheme() == QLatin1String("wss"));
+	QList<QNetworkCookie> matchingCookies;
+
+	for (int i = 0; i < cookies.count(); ++i)
+	{
+		const QNetworkCookie cookie(cookies.at(i));
+		const QString domain(cookie.domain());
+		const QString cookiePath(cookie.path());
+
+		if (domain.startsWith(QLatin1Char('.')) ? !(host.endsWith(domain) || host == domain.mid(1)) : (host != domain))
+		{
+			continue;
+		}
+
+		if (!((path.isEmpty() && cookiePath == QLatin1String("/")) || (path.startsWith(cookiePath) && (path.length() == cookiePath.length() || cookiePath.endsWith(QLatin1Char('/')) || path.at(cookiePath.length()) == QLatin1Char('/')))))
+		{
+			continue;
+		}
+
+		if ((!cookie.isSessionCookie() && cookie.expirationDate() < currentDateTime) || (cookie.isSecure() && !isSecure))
+		{
+			continue;
+		}
+
+		int index(0);
+
+		while (index < matchingCookies.count() && matchingCookies.at(index).path().length() >= cookiePath.length())
+		{
+			++index;
+		}
+
+		matchingCookies.insert(index, cookie);
+	}
+
+	return matchingCookies;
 }
 
 QVector<QNetworkCookie> CookieJar::getCookies(const QString &domain) const
 {
 	if (!domain.isEmpty())
 	{
-		const QList<QNetworkCookie> cookies(allCookies());
+		const QString group(getGroup(domain));
+
+		loadCookies(group);
+
+		const QVector<QNetworkCookie> cookies(m_cookies.value(group));
 		QVector<QNetworkCookie> domainCookies;
 
 		for (int i = 0; i < cookies.count(); ++i)
@@ -236,7 +470,17 @@ QVector<QNetworkCookie> CookieJar::getCookies(const QString &domain) const
 		return domainCookies;
 	}
 
-	return allCookies().toVector();
+	loadAllCookies();
+
+	QVector<QNetworkCookie> cookies;
+	QHash<QString, QVector<QNetworkCookie> >::const_iterator iterator;
+
+	for (iterator = m_cookies.constBegin(); iterator != m_cookies.constEnd(); ++iterator)
+	{
+		cookies.append(iterator.value());
+	}
+
+	return cookies;
 }
 
 bool CookieJar::insertCookie(const QNetworkCookie &cookie)
@@ -246,92 +490,213 @@ bool CookieJar::insertCookie(const QNetworkCookie &cookie)
 		return false;
 	}
 
-	const bool result(QNetworkCookieJar::insertCookie(cookie));
+	return forceInsertCookie(cookie);
+}
 
-	if (result)
+bool CookieJar::updateCookie(const QNetworkCookie &cookie)
+{
+	if (m_generalCookiesPolicy == IgnoreCookies || m_generalCookiesPolicy == ReadOnlyCookies)
 	{
-		scheduleSave();
-
-		emit cookieAdded(cookie);
+		return false;
 	}
 
-	return result;
+	return forceUpdateCookie(cookie);
 }
 
-bool CookieJar::updateCookie(const QNetworkCookie &cookie)
+bool CookieJar::deleteCookie(const QNetworkCookie &cookie)
 {
 	if (m_generalCookiesPolicy == IgnoreCookies || m_generalCookiesPolicy == ReadOnlyCookies)
 	{
 		return false;
 	}
 
-	const bool result(QNetworkCookieJar::updateCookie(cookie));
+	return forceDeleteCookie(cookie);
+}
+
+bool CookieJar::forceInsertCookie(const QNetworkCookie &cookie)
+{
+	loadCookies(getGroup(cookie.domain()));
+
+	QNetworkCookie replacedCookie;
+
+	if (!cookie.isSessionCookie() && cookie.expirationDate() < QDateTime::currentDateTimeUtc())
+	{
+		if (removeCookie(cookie, &replacedCookie))
+		{
+			if (!replacedCookie.isSessionCookie())
+			{
+				addRecord(RemoveCookie, replacedCookie);
+			}
+
+			emit cookieRemoved(replacedCookie);
+		}
+
+		return false;
+	}
+
+	const bool hasReplacedCookie(storeCookie(cookie, &replacedCookie));
+
+	if (!cookie.isSessionCookie())
+	{
+		addRecord(InsertCookie, cookie);
+	}
+	else if (hasReplacedCookie && !replacedCookie.isSessionCookie())
+	{
+		addRecord(RemoveCookie, replacedCookie);
+	}
 
-	if (result)
+	if (hasReplacedCookie)
 	{
-		scheduleSave();
+		emit cookieRemoved(replacedCookie);
 	}
 
-	return result;
+	emit cookieAdded(cookie);
+
+	return true;
 }
 
-bool CookieJar::deleteCookie(const QNetworkCookie &cookie)
+bool CookieJar::forceUpdateCookie(const QNetworkCookie &cookie)
 {
-	if (m_generalCookiesPolicy == IgnoreCookies || m_generalCookiesPolicy == ReadOnlyCookies)
+	const QString group(getGroup(cookie.domain()));
+
+	loadCookies(group);
+
+	const QVector<QNetworkCookie> cookies(m_cookies.value(group));
+
+	for (int i = 0; i < cookies.count(); ++i)
 	{
-		return false;
+		if (cookies.at(i).hasSameIdentifier(cookie))
+		{
+			return forceInsertCookie(cookie);
+		}
 	}
 
-	const bool result(QNetworkCookieJar::deleteCookie(cookie));
+	return false;
+}
 
-	if (result)
+bool CookieJar::forceDeleteCookie(const QNetworkCookie &cookie)
+{
+	loadCookies(getGroup(cookie.domain()));
+
+	QNetworkCookie removedCookie;
+
+	if (!removeCookie(cookie, &removedCookie))
 	{
-		scheduleSave();
+		return false;
+	}
 
-		emit cookieRemoved(cookie);
+	if (!removedCookie.isSessionCookie())
+	{
+		addRecord(RemoveCookie, removedCookie);
 	}
 
-	return result;
+	emit cookieRemoved(cookie);
+
+	return true;
 }
 
-bool CookieJar::forceInsertCookie(const QNetworkCookie &cookie)
+bool CookieJar::storeCookie(const QNetworkCookie &cookie, QNetworkCookie *replacedCookie) const
 {
-	const bool result(QNetworkCookieJar::insertCookie(cookie));
+	QVector<QNetworkCookie> &cookies(m_cookies[getGroup(cookie.domain())]);
 
-	if (result)
+	for (int i = 0; i < cookies.count(); ++i)
 	{
-		scheduleSave();
+		if (cookies.at(i).hasSameIdentifier(cookie))
+		{
+			if (replacedCookie)
+			{
+				*replacedCookie = cookies.at(i);
+			}
+
+			cookies[i] = cookie;
 
-		emit cookieAdded(cookie);
+			return true;
+		}
 	}
 
-	return result;
+	cookies.append(cookie);
+
+	return false;
 }
 
-bool CookieJar::forceUpdateCookie(const QNetworkCookie &cookie)
+bool CookieJar::removeCookie(const QNetworkCookie &cookie, QNetworkCookie *removedCookie) const
 {
-	const bool result(QNetworkCookieJar::updateCookie(cookie));
+	const QString group(getGroup(cookie.domain()));
 
-	if (result)
+	if (!m_cookies.contains(group))
 	{
-		scheduleSave();
+		return false;
 	}
 
-	return result;
+	QVector<QNetworkCookie> &cookies(m_cookies[group]);
+
+	for (int i = 0; i < cookies.count(); ++i)
+	{
+		if (cookies.at(i).hasSameIdentifier(cookie))
+		{
+			if (removedCookie)
+			{
+				*removedCookie = cookies.at(i);
+			}
+
+			cookies.remove(i);
+
+			if (cookies.isEmpty())
+			{
+				m_cookies.remove(group);
+			}
+
+			return true;
+		}
+	}
+
+	return false;
 }
 
-bool CookieJar::forceDeleteCookie(const QNetworkCookie &cookie)
+bool CookieJar::writeCookies()
 {
-	const bool result(QNetworkCookieJar::deleteCookie(cookie));
+	loadAllCookies();
 
-	if (result)
+	QSaveFile file(m_path);
+
+	if (!file.open(QIODevice::WriteOnly))
 	{
-		scheduleSave();
+		return false;
+	}
+
+	const QDateTime currentDateTime(QDateTime::currentDateTimeUtc());
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_6);
+	stream << static_cast<quint32>(COOKIES_MAGIC) << static_cast<quint32>(COOKIES_VERSION);
 
-		emit cookieRemoved(cookie);
+	QHash<QString, QVector<QNetworkCookie> >::const_iterator iterator;
+
+	for (iterator = m_cookies.constBegin(); iterator != m_cookies.constEnd(); ++iterator)
+	{
+		for (int i = 0; i < iterator.value().count(); ++i)
+		{
+			const QNetworkCookie cookie(iterator.value().at(i));
+
+			if (!cookie.isSessionCookie() && cookie.expirationDate() >= currentDateTime)
+			{
+				stream << static_cast<quint8>(InsertCookie) << iterator.key() << cookie.toRawForm();
+			}
+		}
+	}
+
+	if (!file.commit())
+	{
+		return false;
 	}
 
-	return result;
+	QFile::remove(getJournalPath());
+
+	m_pendingRecords.clear();
+
+	m_journalRecordsAmount = 0;
+	m_needsCompaction = false;
+
+	return true;
 }
 
 bool CookieJar::hasCookie(const QNetworkCookie &cookie) const
@@ -20,6 +20,8 @@
 #ifndef OTTER_COOKIEJAR_H
 #define OTTER_COOKIEJAR_H
 
+#include <QtCore/QHash>
+#include <QtCore/QVector>
 #include <QtNetwork/QNetworkCookie>
 #include <QtNetwork/QNetworkCookieJar>
 
@@ -70,19 +72,45 @@ public:
 	static bool isDomainTheSame(const QUrl &first, const QUrl &second);
 
 protected:
+	struct CookieRecord final
+	{
+		QNetworkCookie cookie;
+		CookieOperation operation;
+	};
+
+	struct RecordLocation final
+	{
+		qint64 offset;
+		bool isJournal;
+	};
+
 	void timerEvent(QTimerEvent *event) override;
 	void scheduleSave();
 	void save();
+	void readRecords(const QString &path, bool isJournal);
+	void loadCookies(const QString &group) const;
+	void loadAllCookies() const;
+	void addRecord(CookieOperation operation, const QNetworkCookie &cookie);
+	bool storeCookie(const QNetworkCookie &cookie, QNetworkCookie *replacedCookie = nullptr) const;
+	bool removeCookie(const QNetworkCookie &cookie, QNetworkCookie *removedCookie = nullptr) const;
+	bool writeCookies();
+	static QString getGroup(const QString &domain);
+	QString getJournalPath() const;
 
 protected slots:
 	void handleOptionChanged(int identifier, const QVariant &value);
 
 private:
 	QString m_path;
+	QVector<CookieRecord> m_pendingRecords;
+	mutable QHash<QString, QVector<QNetworkCookie> > m_cookies;
+	mutable QHash<QString, QVector<RecordLocation> > m_locations;
 	CookiesPolicy m_generalCookiesPolicy;
 	CookiesPolicy m_thirdPartyCookiesPolicy;
 	KeepMode m_keepMode;
+	int m_journalRecordsAmount;
 	int m_saveTimer;
+	bool m_needsCompaction;
 
 signals:
 	void cookieAdded(QNetworkCookie cookie);
@@ -0,0 +1,487 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "FaviconsDatabase.h"
+#include "SessionsManager.h"
+#include "Utils.h"
+
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtCore/QBuffer>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QSaveFile>
+#include <QtCore/QSet>
+
+#define FAVICONS_CACHE_LIMIT 1000
+#define FAVICONS_COMPACTION_MINIMUM 500
+#define FAVICONS_DATABASE_MAGIC 0x4F464944
+#define FAVICONS_DATABASE_VERSION 1
+
+namespace Otter
+{
+
+FaviconsDatabase::FaviconsDatabase(const QString &path, QObject *parent) : QObject(parent),
+	m_path(path),
+	m_file(path),
+	m_cache(FAVICONS_CACHE_LIMIT),
+	m_data(nullptr),
+	m_recordsAmount(0),
+	m_isLoaded(false)
+{
+	m_threadPool.setMaxThreadCount(1);
+}
+
+FaviconsDatabase::~FaviconsDatabase()
+{
+	m_threadPool.waitForDone();
+}
+
+void FaviconsDatabase::load()
+{
+	const QMutexLocker locker(&m_mutex);
+
+	m_isLoaded = true;
+
+	if (!m_file.open(QIODevice::ReadOnly) || m_file.size() == 0)
+	{
+		return;
+	}
+
+	m_data = m_file.map(0, m_file.size());
+
+	if (!m_data)
+	{
+		m_file.close();
+
+		return;
+	}
+
+	QByteArray data(QByteArray::fromRawData(reinterpret_cast<const char*>(m_data), static_cast<int>(m_file.size())));
+	QBuffer buffer(&data);
+	buffer.open(QIODevice::ReadOnly);
+
+	QDataStream stream(&buffer);
+	stream.setVersion(QDataStream::Qt_5_6);
+
+	quint32 magic(0);
+	quint32 version(0);
+
+	stream >> magic >> version;
+
+	if (stream.status() != QDataStream::Ok || magic != FAVICONS_DATABASE_MAGIC || version != FAVICONS_DATABASE_VERSION)
+	{
+		m_file.unmap(m_data);
+		m_file.close();
+
+		m_data = nullptr;
+
+		QFile::remove(m_path);
+
+		return;
+	}
+
+	while (!stream.atEnd())
+	{
+		quint8 type(0);
+		QByteArray hash;
+
+		stream >> type >> hash;
+
+		if (type == IconRecord)
+		{
+			quint32 size(0);
+
+			stream >> size;
+
+			IconLocation location;
+			location.offset = buffer.pos();
+			location.size = static_cast<int>(size);
+
+			if (stream.skipRawData(static_cast<int>(size)) != static_cast<int>(size))
+			{
+				break;
+			}
+
+			m_icons[hash] = location;
+
+			++m_recordsAmount;
+		}
+		else if (type == KeyRecord)
+		{
+			QString key;
+
+			stream >> key;
+
+			if (stream.status() != QDataStream::Ok)
+			{
+				break;
+			}
+
+			m_keys[key] = hash;
+
+			++m_recordsAmount;
+		}
+		else
+		{
+			break;
+		}
+	}
+
+	if (needsCompaction() && !SessionsManager::isReadOnly())
+	{
+		QtConcurrent::run(&m_threadPool, [=]()
+		{
+			const QMutexLocker locker(&m_mutex);
+
+			if (needsCompaction())
+			{
+				compact();
+			}
+		});
+	}
+}
+
+void FaviconsDatabase::clear()
+{
+	m_threadPool.waitForDone();
+
+	const QMutexLocker locker(&m_mutex);
+
+	if (m_data)
+	{
+		m_file.unmap(m_data);
+
+		m_data = nullptr;
+	}
+
+	m_file.close();
+	m_cache.clear();
+	m_icons.clear();
+	m_keys.clear();
+
+	m_recordsAmount = 0;
+
+	QFile::remove(m_path);
+}
+
+void FaviconsDatabase::setIcon(const QUrl &url, const QIcon &icon)
+{
+	if (icon.isNull() || SessionsManager::isReadOnly())
+	{
+		return;
+	}
+
+	const QStringList keys(createKeys(url));
+
+	if (keys.isEmpty())
+	{
+		return;
+	}
+
+	for (int i = 0; i < keys.count(); ++i)
+	{
+		m_cache.insert(keys.at(i), new QIcon(icon));
+	}
+
+	if (!m_isLoaded)
+	{
+		load();
+	}
+
+	const QImage image(icon.pixmap(16, 16).toImage());
+
+	QtConcurrent::run(&m_threadPool, [=]()
+	{
+		writeIcon(keys, image);
+	});
+}
+
+void FaviconsDatabase::writeIcon(const QStringList &keys, const QImage &image)
+{
+	QByteArray data;
+	QBuffer buffer(&data);
+	buffer.open(QIODevice::WriteOnly);
+
+	if (!image.save(&buffer, "PNG"))
+	{
+		return;
+	}
+
+	const QByteArray hash(QCryptographicHash::hash(data, QCryptographicHash::Sha1));
+	const QMutexLocker locker(&m_mutex);
+	QStringList changedKeys;
+
+	for (int i = 0; i < keys.count(); ++i)
+	{
+		if (m_keys.value(keys.at(i)) != hash)
+		{
+			changedKeys.append(keys.at(i));
+		}
+	}
+
+	if (changedKeys.isEmpty())
+	{
+		return;
+	}
+
+	QFile file(m_path);
+
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Append))
+	{
+		return;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_6);
+
+	if (file.size() == 0)
+	{
+		stream << static_cast<quint32>(FAVICONS_DATABASE_MAGIC) << static_cast<quint32>(FAVICONS_DATABASE_VERSION);
+	}
+
+	if (!m_icons.contains(hash))
+	{
+		stream << static_cast<quint8>(IconRecord) << hash << data;
+
+		IconLocation location;
+		location.data = data;
+		location.size = data.size();
+
+		m_icons[hash] = location;
+
+		++m_recordsAmount;
+	}
+
+	for (int i = 0; i < changedKeys.count(); ++i)
+	{
+		stream << static_cast<quint8>(KeyRecord) << hash << changedKeys.at(i);
+
+		m_keys[changedKeys.at(i)] = hash;
+
+		++m_recordsAmount;
+	}
+
+	file.close();
+
+	if (needsCompaction())
+	{
+		compact();
+	}
+}
+
+void FaviconsDatabase::compact()
+{
+	QSaveFile file(m_path);
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		return;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_6);
+	stream << static_cast<quint32>(FAVICONS_DATABASE_MAGIC) << static_cast<quint32>(FAVICONS_DATABASE_VERSION);
+
+	QHash<QByteArray, IconLocation> icons;
+	QHash<QString, QByteArray> keys;
+	QSet<QByteArray> missingIcons;
+	QHash<QString, QByteArray>::const_iterator iterator;
+
+	for (iterator = m_keys.constBegin(); iterator != m_keys.constEnd(); ++iterator)
+	{
+		const QByteArray hash(iterator.value());
+
+		if (missingIcons.contains(hash))
+		{
+			continue;
+		}
+
+		if (!icons.contains(hash))
+		{
+			const IconLocation location(m_icons.value(hash));
+			QByteArray data(location.data);
+
+			if (data.isEmpty() && m_data && location.offset >= 0)
+			{
+				data = QByteArray(reinterpret_cast<const char*>(m_data + location.offset), location.size);
+			}
+
+			if (data.isEmpty())
+			{
+				missingIcons.insert(hash);
+
+				continue;
+			}
+
+			stream << static_cast<quint8>(IconRecord) << hash << static_cast<quint32>(data.size());
+
+			IconLocation newLocation;
+			newLocation.data = data;
+			newLocation.offset = file.pos();
+			newLocation.size = data.size();
+
+			stream.writeRawData(data.constData(), data.size());
+
+			icons[hash] = newLocation;
+		}
+
+		stream << static_cast<quint8>(KeyRecord) << hash << iterator.key();
+
+		keys[iterator.key()] = hash;
+	}
+
+	if (stream.status() != QDataStream::Ok)
+	{
+		file.cancelWriting();
+
+		return;
+	}
+
+	if (m_data)
+	{
+		m_file.unmap(m_data);
+
+		m_data = nullptr;
+	}
+
+	m_file.close();
+
+	const bool isCommitted(file.commit());
+
+	if (m_file.open(QIODevice::ReadOnly))
+	{
+		m_data = m_file.map(0, m_file.size());
+
+		if (!m_data)
+		{
+			m_file.close();
+		}
+	}
+
+	if (!isCommitted)
+	{
+		return;
+	}
+
+	if (m_data)
+	{
+		QHash<QByteArray, IconLocation>::iterator iconsIterator;
+
+		for (iconsIterator = icons.begin(); iconsIterator != icons.end(); ++iconsIterator)
+		{
+			iconsIterator.value().data.clear();
+		}
+	}
+
+	m_icons = icons;
+	m_keys = keys;
+	m_recordsAmount = (icons.count() + keys.count());
+}
+
+QStringList FaviconsDatabase::createKeys(const QUrl &url)
+{
+	if (Utils::isUrlEmpty(url))
+	{
+		return {};
+	}
+
+	QStringList keys({Utils::normalizeUrl(url).toString(QUrl::RemoveFragment)});
+	const QString host(Utils::extractHost(url));
+
+	if (!host.isEmpty())
+	{
+		keys.append(host);
+	}
+
+	return keys;
+}
+
+bool FaviconsDatabase::needsCompaction() const
+{
+	const int deadRecordsAmount(m_recordsAmount - m_icons.count() - m_keys.count());
+
+	return (deadRecordsAmount >= FAVICONS_COMPACTION_MINIMUM && deadRecordsAmount > (m_recordsAmount / 2));
+}
+
+QIcon FaviconsDatabase::getIcon(const QUrl &url)
+{
+	const QStringList keys(createKeys(url));
+
+	if (keys.isEmpty())
+	{
+		return {};
+	}
+
+	if (!m_isLoaded)
+	{
+		load();
+	}
+
+	for (int i = 0; i < keys.count(); ++i)
+	{
+		const QIcon *cachedIcon(m_cache.object(keys.at(i)));
+
+		if (cachedIcon)
+		{
+			return *cachedIcon;
+		}
+
+		QByteArray data;
+
+		m_mutex.lock();
+
+		const QByteArray hash(m_keys.value(keys.at(i)));
+
+		if (!hash.isEmpty() && m_icons.contains(hash))
+		{
+			const IconLocation location(m_icons.value(hash));
+
+			if (!location.data.isEmpty())
+			{
+				data = location.data;
+			}
+			else if (m_data && location.offset >= 0)
+			{
+				data = QByteArray(reinterpret_cast<const char*>(m_data + location.offset), location.size);
+			}
+		}
+
+		m_mutex.unlock();
+
+		if (data.isEmpty())
+		{
+			continue;
+		}
+
+		QImage image;
+
+		if (image.loadFromData(data, "PNG"))
+		{
+			QIcon *icon(new QIcon(QPixmap::fromImage(image)));
+
+			m_cache.insert(keys.at(i), icon);
+
+			return *icon;
+		}
+	}
+
+	return {};
+}
+
+}
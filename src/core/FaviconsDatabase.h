@@ -0,0 +1,80 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_FAVICONSDATABASE_H
+#define OTTER_FAVICONSDATABASE_H
+
+#include <QtCore/QCache>
+#include <QtCore/QFile>
+#include <QtCore/QMutex>
+#include <QtCore/QThreadPool>
+#include <QtCore/QUrl>
+#include <QtGui/QIcon>
+
+namespace Otter
+{
+
+class FaviconsDatabase final : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit FaviconsDatabase(const QString &path, QObject *parent = nullptr);
+	~FaviconsDatabase();
+
+	void clear();
+	void setIcon(const QUrl &url, const QIcon &icon);
+	QIcon getIcon(const QUrl &url);
+
+protected:
+	enum RecordType
+	{
+		IconRecord = 1,
+		KeyRecord
+	};
+
+	struct IconLocation final
+	{
+		QByteArray data;
+		qint64 offset = -1;
+		int size = 0;
+	};
+
+	void load();
+	void writeIcon(const QStringList &keys, const QImage &image);
+	void compact();
+	static QStringList createKeys(const QUrl &url);
+	bool needsCompaction() const;
+
+private:
+	QString m_path;
+	QFile m_file;
+	QThreadPool m_threadPool;
+	QCache<QString, QIcon> m_cache;
+	QHash<QByteArray, IconLocation> m_icons;
+	QHash<QString, QByteArray> m_keys;
+	QMutex m_mutex;
+	uchar *m_data;
+	int m_recordsAmount;
+	bool m_isLoaded;
+};
+
+}
+
+#endif
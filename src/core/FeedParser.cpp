@@ -18,7 +18,6 @@
 **************************************************************************/
 
 #include "FeedParser.h"
-#include "Console.h"
 #include "FeedsManager.h"
 #include "Job.h"
 
@@ -79,6 +78,21 @@ FeedParser* FeedParser::createParser(Feed *feed, DataFetchJob *data)
 	return nullptr;
 }
 
+void FeedParser::addError(const QString &message, Console::MessageCategory category, int line)
+{
+	ParserError error;
+	error.message = message;
+	error.category = category;
+	error.line = line;
+
+	m_errors.append(error);
+}
+
+QVector<FeedParser::ParserError> FeedParser::getErrors() const
+{
+	return m_errors;
+}
+
 QString FeedParser::createIdentifier(const Feed::Entry &entry)
 {
 	if (entry.publicationTime.isValid())
@@ -98,9 +112,9 @@ AtomFeedParser::AtomFeedParser() : FeedParser()
 	m_information.mimeType = QMimeDatabase().mimeTypeForName(QLatin1String("application/atom+xml"));
 }
 
-void AtomFeedParser::parse(DataFetchJob *data)
+bool AtomFeedParser::parse(const QByteArray &data)
 {
-	QXmlStreamReader reader(data->getData());
+	QXmlStreamReader reader(data);
 	bool isSuccess(true);
 
 	m_information.entries.reserve(10);
@@ -219,7 +233,7 @@ void AtomFeedParser::parse(DataFetchJob *data)
 
 			if (reader.hasError())
 			{
-				Console::addMessage(tr("Failed to parse feed file: %1").arg(reader.errorString()), Console::OtherCategory, Console::ErrorLevel, data->getUrl().toDisplayString());
+				addError(tr("Failed to parse feed file: %1").arg(reader.errorString()), Console::OtherCategory);
 
 				isSuccess = false;
 			}
@@ -230,12 +244,12 @@ void AtomFeedParser::parse(DataFetchJob *data)
 
 	if (m_information.entries.isEmpty())
 	{
-		Console::addMessage(tr("Failed to parse feed: no valid entries found"), Console::NetworkCategory, Console::ErrorLevel, data->getUrl().toDisplayString());
+		addError(tr("Failed to parse feed: no valid entries found"), Console::NetworkCategory);
 
 		isSuccess = false;
 	}
 
-	emit parsingFinished(isSuccess);
+	return isSuccess;
 }
 
 FeedParser::FeedInformation AtomFeedParser::getInformation() const
@@ -256,9 +270,9 @@ RssFeedParser::RssFeedParser() : FeedParser()
 	m_information.mimeType = QMimeDatabase().mimeTypeForName(QLatin1String("application/rss+xml"));
 }
 
-void RssFeedParser::parse(DataFetchJob *data)
+bool RssFeedParser::parse(const QByteArray &data)
 {
-	QXmlStreamReader reader(data->getData());
+	QXmlStreamReader reader(data);
 	bool isSuccess(true);
 	QRegularExpression emailExpression(QLatin1String(R"(^[a-zA-Z0-9\._\-]+@[a-zA-Z0-9\._\-]+\.[a-zA-Z0-9]+$)"));
 	emailExpression.optimize();
@@ -382,7 +396,7 @@ void RssFeedParser::parse(DataFetchJob *data)
 
 			if (reader.hasError())
 			{
-				Console::addMessage(tr("Failed to parse feed file: %1").arg(reader.errorString()), Console::OtherCategory, Console::ErrorLevel, data->getUrl().toDisplayString(), static_cast<int>(reader.lineNumber()));
+				addError(tr("Failed to parse feed file: %1").arg(reader.errorString()), Console::OtherCategory, static_cast<int>(reader.lineNumber()));
 
 				isSuccess = false;
 			}
@@ -393,12 +407,12 @@ void RssFeedParser::parse(DataFetchJob *data)
 
 	if (m_information.entries.isEmpty())
 	{
-		Console::addMessage(tr("Failed to parse feed: no valid entries found"), Console::NetworkCategory, Console::ErrorLevel, data->getUrl().toDisplayString());
+		addError(tr("Failed to parse feed: no valid entries found"), Console::NetworkCategory);
 
 		isSuccess = false;
 	}
 
-	emit parsingFinished(isSuccess);
+	return isSuccess;
 }
 
 FeedParser::FeedInformation RssFeedParser::getInformation() const
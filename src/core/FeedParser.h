@@ -20,6 +20,7 @@
 #ifndef OTTER_FEEDPARSER_H
 #define OTTER_FEEDPARSER_H
 
+#include "Console.h"
 #include "FeedsManager.h"
 
 #include <QtCore/QMimeType>
@@ -53,17 +54,26 @@ public:
 		QVector<Feed::Entry> entries;
 	};
 
+	struct ParserError final
+	{
+		QString message;
+		Console::MessageCategory category = Console::OtherCategory;
+		int line = -1;
+	};
+
 	explicit FeedParser();
 
-	virtual void parse(DataFetchJob *data) = 0;
+	virtual bool parse(const QByteArray &data) = 0;
 	virtual FeedInformation getInformation() const = 0;
+	QVector<ParserError> getErrors() const;
 	static FeedParser* createParser(Feed *feed, DataFetchJob *data);
 
 protected:
+	void addError(const QString &message, Console::MessageCategory category, int line = -1);
 	static QString createIdentifier(const Feed::Entry &entry);
 
-signals:
-	void parsingFinished(bool isSuccess);
+private:
+	QVector<ParserError> m_errors;
 };
 
 class AtomFeedParser final : public FeedParser
@@ -71,7 +81,7 @@ class AtomFeedParser final : public FeedParser
 public:
 	explicit AtomFeedParser();
 
-	void parse(DataFetchJob *data) override;
+	bool parse(const QByteArray &data) override;
 	FeedInformation getInformation() const override;
 
 protected:
@@ -86,7 +96,7 @@ class RssFeedParser final : public FeedParser
 public:
 	explicit RssFeedParser();
 
-	void parse(DataFetchJob *data) override;
+	bool parse(const QByteArray &data) override;
 	FeedInformation getInformation() const override;
 
 protected:
@@ -28,18 +28,24 @@
 #include "SessionsManager.h"
 #include "Utils.h"
 
+#include <QtConcurrent/QtConcurrentRun>
 #include <QtCore/QFile>
+#include <QtCore/QFutureWatcher>
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
 #include <QtCore/QSaveFile>
 
+#define FEEDS_HOST_UPDATES_LIMIT 2
+#define FEEDS_PARSER_THREADS 2
+#define FEEDS_UPDATES_LIMIT 8
+#define FEEDS_UPDATE_TIMEOUT 60
+
 namespace Otter
 {
 
 Feed::Feed(const QString &title, const QUrl &url, const QIcon &icon, int updateInterval, QObject *parent) : QObject(parent),
 	m_updateTimer(nullptr),
-	m_parser(nullptr),
 	m_title(title),
 	m_url(url),
 	m_icon(icon),
@@ -167,19 +173,35 @@ void Feed::setUpdateInterval(int interval)
 			{
 				m_updateTimer = new LongTermTimer(this);
 
-				connect(m_updateTimer, &LongTermTimer::timeout, this, &Feed::update);
+				connect(m_updateTimer, &LongTermTimer::timeout, this, [&]()
+				{
+					scheduleUpdate(false);
+				});
 			}
 
-			m_updateTimer->start(static_cast<quint64>(interval) * 60000);
+			const quint64 updateInterval(static_cast<quint64>(interval) * 60000);
+
+			m_updateTimer->start(updateInterval + (qHash(m_url.toString()) % ((updateInterval / 10) + 1)));
 		}
 
 		emit feedModified(this);
 	}
 }
 
+void Feed::setValidators(const QByteArray &entityTag, const QByteArray &lastModified)
+{
+	m_entityTag = entityTag;
+	m_lastModified = lastModified;
+}
+
 void Feed::update()
 {
-	if (m_parser)
+	scheduleUpdate(true);
+}
+
+void Feed::scheduleUpdate(bool isUrgent)
+{
+	if (m_isUpdating)
 	{
 		return;
 	}
@@ -189,7 +211,23 @@ void Feed::update()
 
 	emit feedModified(this);
 
+	FeedsManager::scheduleUpdate(this, isUrgent);
+}
+
+void Feed::startUpdate()
+{
 	DataFetchJob *dataJob(new DataFetchJob(m_url, this));
+	dataJob->setTimeout(FEEDS_UPDATE_TIMEOUT);
+
+	if (!m_entityTag.isEmpty())
+	{
+		dataJob->setHeader(QByteArrayLiteral("If-None-Match"), m_entityTag);
+	}
+
+	if (!m_lastModified.isEmpty())
+	{
+		dataJob->setHeader(QByteArrayLiteral("If-Modified-Since"), m_lastModified);
+	}
 
 	connect(dataJob, &DataFetchJob::progressChanged, this, [&](int progress)
 	{
@@ -199,168 +237,209 @@ void Feed::update()
 	});
 	connect(dataJob, &DataFetchJob::jobFinished, this, [=](bool isDataFetchSuccess)
 	{
-		if (isDataFetchSuccess)
+		FeedsManager::finishUpdate(this);
+
+		if (!isDataFetchSuccess)
+		{
+			m_error = DownloadError;
+			m_isUpdating = false;
+
+			Console::addMessage(tr("Failed to download feed"), Console::NetworkCategory, Console::ErrorLevel, m_url.toDisplayString());
+
+			emit feedModified(this);
+
+			return;
+		}
+
+		if (!dataJob->isModified())
+		{
+			m_lastSynchronizationTime = QDateTime::currentDateTimeUtc();
+			m_isUpdating = false;
+
+			emit feedModified(this);
+
+			return;
+		}
+
+		FeedParser *parser(FeedParser::createParser(this, dataJob));
+
+		if (!parser)
+		{
+			m_error = ParseError;
+			m_isUpdating = false;
+
+			Console::addMessage(tr("Failed to parse feed: unknown feed format"), Console::NetworkCategory, Console::ErrorLevel, m_url.toDisplayString());
+
+			emit feedModified(this);
+
+			return;
+		}
+
+		const QMap<QByteArray, QByteArray> headers(dataJob->getHeaders());
+		const QByteArray data(dataJob->getData()->readAll());
+		const QString source(dataJob->getUrl().toDisplayString());
+		QFutureWatcher<bool> *watcher(new QFutureWatcher<bool>(this));
+
+		connect(watcher, &QFutureWatcher<bool>::finished, this, [=]()
 		{
-			m_parser = FeedParser::createParser(this, dataJob);
+			const FeedParser::FeedInformation information(parser->getInformation());
+			const QVector<FeedParser::ParserError> errors(parser->getErrors());
+			const bool isParsingSuccess(watcher->result());
 
-			if (m_parser)
+			for (int i = 0; i < errors.count(); ++i)
 			{
-				m_parser->moveToThread(&m_parserThread);
+				Console::addMessage(errors.at(i).message, errors.at(i).category, Console::ErrorLevel, source, errors.at(i).line);
+			}
 
-				connect(m_parser, &FeedParser::parsingFinished, m_parser, [&](bool isParsingSuccess)
+			m_entityTag.clear();
+			m_lastModified.clear();
+
+			if (isParsingSuccess)
+			{
+				QMap<QByteArray, QByteArray>::const_iterator iterator;
+
+				for (iterator = headers.begin(); iterator != headers.end(); ++iterator)
 				{
-					const FeedParser::FeedInformation information(m_parser->getInformation());
+					const QByteArray header(iterator.key().toLower());
 
-					if (!isParsingSuccess)
+					if (header == QByteArrayLiteral("etag"))
 					{
-						m_error = ParseError;
+						m_entityTag = iterator.value();
 					}
-
-					if (m_icon.isNull() && information.icon.isValid())
+					else if (header == QByteArrayLiteral("last-modified"))
 					{
-						IconFetchJob *iconJob(new IconFetchJob(information.icon, this));
-
-						connect(iconJob, &IconFetchJob::jobFinished, this, [=](bool isIconFetchSuccess)
-						{
-							if (isIconFetchSuccess)
-							{
-								setIcon(iconJob->getIcon());
-							}
-						});
-
-						iconJob->start();
+						m_lastModified = iterator.value();
 					}
+				}
+			}
+			else
+			{
+				m_error = ParseError;
+			}
 
-					if (m_title.isEmpty())
-					{
-						m_title = information.title;
-					}
+			if (m_icon.isNull() && information.icon.isValid())
+			{
+				IconFetchJob *iconJob(new IconFetchJob(information.icon, this));
 
-					if (m_description.isEmpty())
+				connect(iconJob, &IconFetchJob::jobFinished, this, [=](bool isIconFetchSuccess)
+				{
+					if (isIconFetchSuccess)
 					{
-						m_description = information.description;
+						setIcon(iconJob->getIcon());
 					}
+				});
 
-					if (!information.entries.isEmpty())
-					{
-						QStringList existingRemovedEntries;
-						int amount(0);
+				iconJob->start();
+			}
 
-						for (int i = (information.entries.count() - 1); i >= 0; --i)
-						{
-							Feed::Entry entry(information.entries.at(i));
+			if (m_title.isEmpty())
+			{
+				m_title = information.title;
+			}
 
-							if (m_removedEntries.contains(entry.identifier))
-							{
-								existingRemovedEntries.append(entry.identifier);
-							}
-							else
-							{
-								bool hasEntry(false);
+			if (m_description.isEmpty())
+			{
+				m_description = information.description;
+			}
 
-								for (int j = 0; j < m_entries.count(); ++j)
-								{
-									const Feed::Entry existingEntry(m_entries.at(j));
+			if (!information.entries.isEmpty())
+			{
+				QStringList existingRemovedEntries;
+				int amount(0);
 
-									if (existingEntry.identifier == entry.identifier)
-									{
-										if ((entry.publicationTime.isValid() && existingEntry.publicationTime != entry.publicationTime) || (entry.updateTime.isValid() && existingEntry.updateTime != entry.updateTime))
-										{
-											++amount;
-										}
+				for (int i = (information.entries.count() - 1); i >= 0; --i)
+				{
+					Feed::Entry entry(information.entries.at(i));
 
-										entry.publicationTime = normalizeTime(entry.publicationTime);
+					if (m_removedEntries.contains(entry.identifier))
+					{
+						existingRemovedEntries.append(entry.identifier);
+					}
+					else
+					{
+						bool hasEntry(false);
 
-										if (entry.updateTime.isValid())
-										{
-											entry.updateTime = normalizeTime(entry.updateTime);
-										}
+						for (int j = 0; j < m_entries.count(); ++j)
+						{
+							const Feed::Entry existingEntry(m_entries.at(j));
 
-										m_entries[j] = entry;
+							if (existingEntry.identifier == entry.identifier)
+							{
+								if ((entry.publicationTime.isValid() && existingEntry.publicationTime != entry.publicationTime) || (entry.updateTime.isValid() && existingEntry.updateTime != entry.updateTime))
+								{
+									++amount;
+								}
 
-										hasEntry = true;
+								entry.publicationTime = normalizeTime(entry.publicationTime);
 
-										break;
-									}
+								if (entry.updateTime.isValid())
+								{
+									entry.updateTime = normalizeTime(entry.updateTime);
 								}
 
-								if (!hasEntry)
-								{
-									++amount;
+								m_entries[j] = entry;
 
-									entry.publicationTime = normalizeTime(entry.publicationTime);
-									entry.updateTime = normalizeTime(entry.updateTime);
+								hasEntry = true;
 
-									m_entries.prepend(entry);
-								}
+								break;
 							}
 						}
 
-						m_removedEntries = existingRemovedEntries;
-
-						if (amount > 0)
+						if (!hasEntry)
 						{
-							Notification::Message message;
-							message.message = getTitle() + QLatin1Char('\n') + tr("%n new message(s)", nullptr, amount);
-							message.icon = getIcon();
-							message.event = NotificationsManager::FeedUpdatedEvent;
+							++amount;
 
-							if (message.icon.isNull())
-							{
-								message.icon = ThemesManager::createIcon(QLatin1String("application-rss+xml"));
-							}
+							entry.publicationTime = normalizeTime(entry.publicationTime);
+							entry.updateTime = normalizeTime(entry.updateTime);
 
-							connect(NotificationsManager::createNotification(message, this), &Notification::clicked, this, [&]()
-							{
-								Application::getInstance()->triggerAction(ActionsManager::OpenUrlAction, {{QLatin1String("url"), FeedsManager::createFeedReaderUrl(getUrl())}});
-							});
+							m_entries.prepend(entry);
 						}
-
-						emit entriesModified(this);
 					}
+				}
 
-					m_mimeType = information.mimeType;
-					m_lastSynchronizationTime = QDateTime::currentDateTimeUtc();
-					m_lastUpdateTime = information.lastUpdateTime;
-					m_categories = information.categories;
-
-					m_parserThread.exit();
-
-					m_parser->deleteLater();
-					m_parser = nullptr;
+				m_removedEntries = existingRemovedEntries;
 
-					m_isUpdating = false;
+				if (amount > 0)
+				{
+					Notification::Message message;
+					message.message = getTitle() + QLatin1Char('\n') + tr("%n new message(s)", nullptr, amount);
+					message.icon = getIcon();
+					message.event = NotificationsManager::FeedUpdatedEvent;
 
-					emit feedModified(this);
-				});
+					if (message.icon.isNull())
+					{
+						message.icon = ThemesManager::createIcon(QLatin1String("application-rss+xml"));
+					}
 
-				m_parserThread.start();
+					connect(NotificationsManager::createNotification(message, this), &Notification::clicked, this, [&]()
+					{
+						Application::getInstance()->triggerAction(ActionsManager::OpenUrlAction, {{QLatin1String("url"), FeedsManager::createFeedReaderUrl(getUrl())}});
+					});
+				}
 
-				m_parser->parse(dataJob);
+				emit entriesModified(this);
+			}
 
-				m_updateProgress = -1;
+			m_mimeType = information.mimeType;
+			m_lastSynchronizationTime = QDateTime::currentDateTimeUtc();
+			m_lastUpdateTime = information.lastUpdateTime;
+			m_categories = information.categories;
+			m_isUpdating = false;
 
-				emit updateProgressChanged(-1);
-			}
-			else
-			{
-				m_error = ParseError;
-				m_isUpdating = false;
+			parser->deleteLater();
+			watcher->deleteLater();
 
-				Console::addMessage(tr("Failed to parse feed: unknown feed format"), Console::NetworkCategory, Console::ErrorLevel, m_url.toDisplayString());
+			emit feedModified(this);
+		});
 
-				emit feedModified(this);
-			}
-		}
-		else
+		watcher->setFuture(QtConcurrent::run(FeedsManager::getParserThreadPool(), [=]()
 		{
-			m_error = DownloadError;
-			m_isUpdating = false;
+			return parser->parse(data);
+		}));
 
-			Console::addMessage(tr("Failed to download feed"), Console::NetworkCategory, Console::ErrorLevel, m_url.toDisplayString());
+		m_updateProgress = -1;
 
-			emit feedModified(this);
-		}
+		emit updateProgressChanged(-1);
 	});
 
 	dataJob->start();
@@ -494,6 +573,7 @@ bool FeedsManager::m_isInitialized(false);
 FeedsManager::FeedsManager(QObject *parent) : QObject(parent),
 	m_saveTimer(0)
 {
+	m_parserThreadPool.setMaxThreadCount(FEEDS_PARSER_THREADS);
 }
 
 void FeedsManager::timerEvent(QTimerEvent *event)
@@ -539,6 +619,7 @@ void FeedsManager::ensureInitialized()
 			feed->setLastUpdateTime(QDateTime::fromString(feedObject.value(QLatin1String("lastUpdateTime")).toString(), Qt::ISODate));
 			feed->setLastSynchronizationTime(QDateTime::fromString(feedObject.value(QLatin1String("lastSynchronizationTime")).toString(), Qt::ISODate));
 			feed->setRemovedEntries(feedObject.value(QLatin1String("removedEntries")).toVariant().toStringList());
+			feed->setValidators(feedObject.value(QLatin1String("entityTag")).toString().toLatin1(), feedObject.value(QLatin1String("lastModified")).toString().toLatin1());
 
 			if (feedObject.contains(QLatin1String("categories")))
 			{
@@ -589,6 +670,64 @@ void FeedsManager::ensureInitialized()
 	}
 }
 
+void FeedsManager::scheduleUpdate(Feed *feed, bool isUrgent)
+{
+	if (!m_instance || m_instance->m_updatesQueue.contains(feed))
+	{
+		return;
+	}
+
+	if (isUrgent)
+	{
+		m_instance->m_updatesQueue.prepend(feed);
+	}
+	else
+	{
+		m_instance->m_updatesQueue.enqueue(feed);
+	}
+
+	m_instance->processUpdates();
+}
+
+void FeedsManager::finishUpdate(Feed *feed)
+{
+	const QString host(m_instance->m_updatingFeeds.take(feed));
+
+	if (m_instance->m_hostUpdates.value(host) > 1)
+	{
+		--m_instance->m_hostUpdates[host];
+	}
+	else
+	{
+		m_instance->m_hostUpdates.remove(host);
+	}
+
+	m_instance->processUpdates();
+}
+
+void FeedsManager::processUpdates()
+{
+	for (int i = 0; (i < m_updatesQueue.count() && m_updatingFeeds.count() < FEEDS_UPDATES_LIMIT); ++i)
+	{
+		Feed *feed(m_updatesQueue.at(i));
+		const QString host(feed->getUrl().host());
+
+		if (m_hostUpdates.value(host) >= FEEDS_HOST_UPDATES_LIMIT)
+		{
+			continue;
+		}
+
+		m_updatesQueue.removeAt(i);
+
+		--i;
+		++m_hostUpdates[host];
+
+		m_updatingFeeds[feed] = host;
+
+		feed->startUpdate();
+	}
+}
+
 void FeedsManager::scheduleSave()
 {
 	if (Application::isAboutToQuit())
@@ -669,6 +808,16 @@ void FeedsManager::save()
 			feedObject.insert(QLatin1String("removedEntries"), QJsonArray::fromStringList(feed->getRemovedEntries()));
 		}
 
+		if (!feed->m_entityTag.isEmpty())
+		{
+			feedObject.insert(QLatin1String("entityTag"), QString::fromLatin1(feed->m_entityTag));
+		}
+
+		if (!feed->m_lastModified.isEmpty())
+		{
+			feedObject.insert(QLatin1String("lastModified"), QString::fromLatin1(feed->m_lastModified));
+		}
+
 		const QVector<Feed::Entry> entries(feed->getEntries());
 		QJsonArray entriesArray;
 
@@ -752,6 +901,11 @@ FeedsManager* FeedsManager::getInstance()
 	return m_instance;
 }
 
+QThreadPool* FeedsManager::getParserThreadPool()
+{
+	return &m_instance->m_parserThreadPool;
+}
+
 FeedsModel* FeedsManager::getModel()
 {
 	ensureInitialized();
@@ -24,13 +24,13 @@
 
 #include <QtCore/QDateTime>
 #include <QtCore/QMimeType>
-#include <QtCore/QThread>
+#include <QtCore/QQueue>
+#include <QtCore/QThreadPool>
 
 namespace Otter
 {
 
 class FeedsManager;
-class FeedParser;
 class LongTermTimer;
 
 class Feed final : public QObject
@@ -91,15 +91,16 @@ public slots:
 	void update();
 
 protected:
+	void scheduleUpdate(bool isUrgent);
+	void startUpdate();
 	void setCategories(const QMap<QString, QString> &categories);
 	void setRemovedEntries(const QStringList &removedEntries);
 	void setEntries(const QVector<Entry> &entries);
+	void setValidators(const QByteArray &entityTag, const QByteArray &lastModified);
 	static QDateTime normalizeTime(const QDateTime &time);
 
 private:
 	LongTermTimer *m_updateTimer;
-	FeedParser *m_parser;
-	QThread m_parserThread;
 	QString m_title;
 	QString m_description;
 	QUrl m_url;
@@ -107,6 +108,8 @@ private:
 	QDateTime m_lastUpdateTime;
 	QDateTime m_lastSynchronizationTime;
 	QMimeType m_mimeType;
+	QByteArray m_entityTag;
+	QByteArray m_lastModified;
 	QMap<QString, QString> m_categories;
 	QStringList m_removedEntries;
 	QVector<Entry> m_entries;
@@ -142,12 +145,20 @@ protected:
 	void timerEvent(QTimerEvent *event) override;
 	static void ensureInitialized();
 	void save();
+	void processUpdates();
+	static void scheduleUpdate(Feed *feed, bool isUrgent);
+	static void finishUpdate(Feed *feed);
+	static QThreadPool* getParserThreadPool();
 
 protected slots:
 	void scheduleSave();
 	void handleFeedModified(Feed *feed);
 
 private:
+	QThreadPool m_parserThreadPool;
+	QQueue<Feed*> m_updatesQueue;
+	QHash<Feed*, QString> m_updatingFeeds;
+	QHash<QString, int> m_hostUpdates;
 	int m_saveTimer;
 
 	static FeedsManager *m_instance;
@@ -159,6 +170,8 @@ signals:
 	void feedAdded(const QUrl &url);
 	void feedModified(const QUrl &url);
 	void feedRemoved(const QUrl &url);
+
+friend class Feed;
 };
 
 }
@@ -21,6 +21,7 @@
 #include "HistoryManager.h"
 #include "AddonsManager.h"
 #include "Application.h"
+#include "FaviconsDatabase.h"
 #include "SessionsManager.h"
 #include "SettingsManager.h"
 #include "ThemesManager.h"
@@ -31,6 +32,7 @@ namespace Otter
 {
 
 HistoryManager* HistoryManager::m_instance(nullptr);
+FaviconsDatabase* HistoryManager::m_faviconsDatabase(nullptr);
 HistoryModel* HistoryManager::m_browsingHistoryModel(nullptr);
 HistoryModel* HistoryManager::m_typedHistoryModel(nullptr);
 bool HistoryManager::m_isEnabled(false);
@@ -138,6 +140,11 @@ void HistoryManager::clearHistory(uint period)
 
 	m_browsingHistoryModel->clearRecentEntries(period);
 	m_typedHistoryModel->clearRecentEntries(period);
+
+	if (period == 0)
+	{
+		getFaviconsDatabase()->clear();
+	}
 }
 
 void HistoryManager::removeEntry(quint64 identifier)
@@ -200,6 +207,11 @@ void HistoryManager::updateEntry(quint64 identifier, const QUrl &url, const QStr
 		entry->setData(title, HistoryModel::TitleRole);
 		entry->setIcon(icon);
 
+		if (m_isStoringFavicons)
+		{
+			getFaviconsDatabase()->setIcon(url, icon);
+		}
+
 		m_instance->scheduleSave();
 	}
 }
@@ -257,6 +269,16 @@ HistoryManager* HistoryManager::getInstance()
 	return m_instance;
 }
 
+FaviconsDatabase* HistoryManager::getFaviconsDatabase()
+{
+	if (!m_faviconsDatabase)
+	{
+		m_faviconsDatabase = new FaviconsDatabase(SessionsManager::getWritableDataPath(QLatin1String("favicons.dat")), m_instance);
+	}
+
+	return m_faviconsDatabase;
+}
+
 HistoryModel* HistoryManager::getBrowsingHistoryModel()
 {
 	if (!m_browsingHistoryModel)
@@ -313,9 +335,9 @@ QIcon HistoryManager::getIcon(const QUrl &url)
 		}
 	}
 
-///TODO
+	const QIcon icon(getFaviconsDatabase()->getIcon(url));
 
-	return ThemesManager::createIcon(QLatin1String("text-html"));
+	return (icon.isNull() ? ThemesManager::createIcon(QLatin1String("text-html")) : icon);
 }
 
 HistoryModel::Entry* HistoryManager::getEntry(quint64 identifier)
@@ -328,14 +350,14 @@ HistoryModel::Entry* HistoryManager::getEntry(quint64 identifier)
 	return m_browsingHistoryModel->getEntry(identifier);
 }
 
-QVector<HistoryModel::HistoryEntryMatch> HistoryManager::findEntries(const QString &prefix, bool isTypedInOnly)
+QVector<HistoryModel::HistoryEntryMatch> HistoryManager::findEntries(const QString &prefix, bool isTypedInOnly, int limit)
 {
 	if (!m_typedHistoryModel)
 	{
 		getTypedHistoryModel();
 	}
 
-	QVector<HistoryModel::HistoryEntryMatch> entries(m_typedHistoryModel->findEntries(prefix, true));
+	QVector<HistoryModel::HistoryEntryMatch> entries(m_typedHistoryModel->findEntries(prefix, true, limit));
 
 	if (!isTypedInOnly)
 	{
@@ -344,7 +366,7 @@ QVector<HistoryModel::HistoryEntryMatch> HistoryManager::findEntries(const QStri
 			getBrowsingHistoryModel();
 		}
 
-		entries.append(m_browsingHistoryModel->findEntries(prefix));
+		entries.append(m_browsingHistoryModel->findEntries(prefix, false, limit));
 	}
 
 	return entries;
@@ -364,6 +386,11 @@ quint64 HistoryManager::addEntry(const QUrl &url, const QString &title, const QI
 
 	const quint64 identifier(m_browsingHistoryModel->addEntry(url, title, icon, QDateTime::currentDateTimeUtc())->getIdentifier());
 
+	if (m_isStoringFavicons && !icon.isNull())
+	{
+		getFaviconsDatabase()->setIcon(url, icon);
+	}
+
 	if (isTypedIn)
 	{
 		if (!m_typedHistoryModel)
@@ -29,6 +29,8 @@
 namespace Otter
 {
 
+class FaviconsDatabase;
+
 class HistoryManager final : public QObject
 {
 	Q_OBJECT
@@ -45,7 +47,7 @@ public:
 	static QDateTime getLastVisitTime(const QUrl &url);
 	static QIcon getIcon(const QUrl &url);
 	static HistoryModel::Entry* getEntry(quint64 identifier);
-	static QVector<HistoryModel::HistoryEntryMatch> findEntries(const QString &prefix, bool isTypedInOnly = false);
+	static QVector<HistoryModel::HistoryEntryMatch> findEntries(const QString &prefix, bool isTypedInOnly = false, int limit = 0);
 	static quint64 addEntry(const QUrl &url, const QString &title = {}, const QIcon &icon = {}, bool isTypedIn = false);
 	static bool hasEntry(const QUrl &url);
 
@@ -55,6 +57,7 @@ protected:
 	void timerEvent(QTimerEvent *event) override;
 	void scheduleSave();
 	void save();
+	static FaviconsDatabase* getFaviconsDatabase();
 
 protected slots:
 	void handleOptionChanged(int identifier);
@@ -64,6 +67,7 @@ private:
 	int m_saveTimer;
 
 	static HistoryManager *m_instance;
+	static FaviconsDatabase *m_faviconsDatabase;
 	static HistoryModel *m_browsingHistoryModel;
 	static HistoryModel *m_typedHistoryModel;
 	static bool m_isEnabled;
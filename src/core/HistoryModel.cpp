@@ -20,14 +20,23 @@
 
 #include "HistoryModel.h"
 #include "Console.h"
-#include "JsonSettings.h"
+#include "HistoryManager.h"
 #include "SessionsManager.h"
-#include "ThemesManager.h"
 #include "Utils.h"
 
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtCore/QDataStream>
 #include <QtCore/QFile>
+#include <QtCore/QFutureWatcher>
 #include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
+#include <QtCore/QSaveFile>
+#include <QtCore/QSet>
+
+#define HISTORY_JOURNAL_MAGIC 0x4F484A4C
+#define HISTORY_JOURNAL_VERSION 1
+#define HISTORY_JOURNAL_LIMIT 1000
 
 namespace Otter
 {
@@ -70,7 +79,7 @@ QIcon HistoryModel::Entry::getIcon() const
 {
 	const QVariant iconData(data(Qt::DecorationRole));
 
-	return (iconData.isNull() ? ThemesManager::createIcon(QLatin1String("text-html")) : iconData.value<QIcon>());
+	return (iconData.isNull() ? HistoryManager::getIcon(getUrl()) : iconData.value<QIcon>());
 }
 
 quint64 HistoryModel::Entry::getIdentifier() const
@@ -79,7 +88,21 @@ quint64 HistoryModel::Entry::getIdentifier() const
 }
 
 HistoryModel::HistoryModel(const QString &path, HistoryType type, QObject *parent) : QStandardItemModel(parent),
-	m_type(type)
+	m_type(type),
+	m_journalRecordsAmount(0),
+	m_isCompacting(false),
+	m_isLoading(true),
+	m_needsCompaction(false)
+{
+	setSortRole(TimeVisitedRole);
+	loadSnapshot(path);
+	loadJournal(getJournalPath(path) + QLatin1String(".old"));
+	loadJournal(getJournalPath(path));
+
+	m_isLoading = false;
+}
+
+void HistoryModel::loadSnapshot(const QString &path)
 {
 	QFile file(path);
 
@@ -94,17 +117,166 @@ HistoryModel::HistoryModel(const QString &path, HistoryType type, QObject *paren
 
 	file.close();
 
-	for (int i = 0; i < historyArray.count(); ++i)
+	QVector<QPair<QDateTime, Entry*> > entries;
+	entries.reserve(historyArray.count());
+
+	for (int i = (historyArray.count() - 1); i >= 0; --i)
 	{
 		const QJsonObject entryObject(historyArray.at(i).toObject());
+		const QUrl url(entryObject.value(QLatin1String("url")).toString());
+		const QUrl normalizedUrl(Utils::normalizeUrl(url));
+
+		if (m_type == TypedHistory && m_urls.contains(normalizedUrl))
+		{
+			continue;
+		}
+
 		QDateTime dateTime(QDateTime::fromString(entryObject.value(QLatin1String("time")).toString(), Qt::ISODate));
 		dateTime.setTimeSpec(Qt::UTC);
 
-		addEntry(QUrl(entryObject.value(QLatin1String("url")).toString()), entryObject.value(QLatin1String("title")).toString(), {}, dateTime);
+		quint64 identifier(static_cast<quint64>(entryObject.value(QLatin1String("identifier")).toDouble()));
+
+		if (identifier == 0 || m_identifiers.contains(identifier))
+		{
+			identifier = (m_identifiers.isEmpty() ? 1 : (m_identifiers.lastKey() + 1));
+		}
+
+		Entry *entry(new Entry());
+		entry->setItemData(url, UrlRole);
+		entry->setItemData(entryObject.value(QLatin1String("title")).toString(), TitleRole);
+		entry->setItemData(dateTime, TimeVisitedRole);
+		entry->setItemData(identifier, IdentifierRole);
+
+		if (!normalizedUrl.isEmpty())
+		{
+			m_urls[normalizedUrl].append(entry);
+		}
+
+		m_identifiers[identifier] = entry;
+
+		entries.append({dateTime, entry});
 	}
 
-	setSortRole(TimeVisitedRole);
-	sort(0, Qt::DescendingOrder);
+	m_completionIndex.addUrls(m_urls.keys().toVector());
+
+	std::stable_sort(entries.begin(), entries.end(), [&](const QPair<QDateTime, Entry*> &first, const QPair<QDateTime, Entry*> &second)
+	{
+		return (first.first > second.first);
+	});
+
+	QList<QStandardItem*> items;
+	items.reserve(entries.count());
+
+	for (int i = 0; i < entries.count(); ++i)
+	{
+		items.append(entries.at(i).second);
+	}
+
+	invisibleRootItem()->appendRows(items);
+}
+
+void HistoryModel::loadJournal(const QString &path)
+{
+	QFile file(path);
+
+	if (!file.exists() || !file.open(QIODevice::ReadWrite))
+	{
+		return;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_6);
+
+	quint32 magic(0);
+	quint32 version(0);
+
+	stream >> magic >> version;
+
+	if (stream.status() != QDataStream::Ok || magic != HISTORY_JOURNAL_MAGIC || version != HISTORY_JOURNAL_VERSION)
+	{
+		Console::addMessage(tr("Failed to load history journal: invalid data"), Console::OtherCategory, Console::ErrorLevel, path);
+
+		file.remove();
+
+		return;
+	}
+
+	qint64 position(file.pos());
+
+	while (!stream.atEnd())
+	{
+		quint8 type(0);
+		quint64 identifier(0);
+		QString url;
+		QString title;
+		QDateTime timeVisited;
+
+		stream >> type >> identifier >> url >> title >> timeVisited;
+
+		if (stream.status() != QDataStream::Ok)
+		{
+			file.resize(position);
+
+			break;
+		}
+
+		position = file.pos();
+
+		++m_journalRecordsAmount;
+
+		switch (type)
+		{
+			case AddRecord:
+			case ModifyRecord:
+				{
+					Entry *entry(getEntry(identifier));
+
+					if (entry)
+					{
+						setData(entry->index(), QUrl(url), UrlRole);
+						setData(entry->index(), title, TitleRole);
+						setData(entry->index(), timeVisited, TimeVisitedRole);
+					}
+					else if (type == AddRecord)
+					{
+						addEntry(QUrl(url), title, {}, timeVisited, identifier);
+					}
+				}
+
+				break;
+			case RemoveRecord:
+				removeEntry(identifier);
+
+				break;
+			case ClearRecord:
+				clearRecentEntries(0);
+
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+void HistoryModel::addRecord(RecordType type, Entry *entry)
+{
+	if (m_isLoading)
+	{
+		return;
+	}
+
+	Record record;
+	record.type = type;
+
+	if (entry)
+	{
+		record.url = entry->getUrl();
+		record.title = entry->data(TitleRole).toString();
+		record.timeVisited = entry->getTimeVisited();
+		record.identifier = entry->getIdentifier();
+	}
+
+	m_pendingRecords.append(record);
 }
 
 void HistoryModel::clearExcessEntries(int limit)
@@ -122,10 +294,16 @@ void HistoryModel::clearRecentEntries(uint period)
 {
 	if (period == 0)
 	{
+		m_pendingRecords.clear();
+
+		addRecord(ClearRecord, nullptr);
 		clear();
 
 		m_urls.clear();
 		m_identifiers.clear();
+		m_completionIndex.clear();
+
+		m_needsCompaction = !m_isLoading;
 
 		emit cleared();
 
@@ -177,6 +355,7 @@ void HistoryModel::removeEntry(quint64 identifier)
 		if (m_urls[url].isEmpty())
 		{
 			m_urls.remove(url);
+			m_completionIndex.removeUrl(url);
 		}
 	}
 
@@ -185,6 +364,8 @@ void HistoryModel::removeEntry(quint64 identifier)
 		m_identifiers.remove(identifier);
 	}
 
+	addRecord(RemoveRecord, entry);
+
 	emit entryRemoved(entry);
 
 	removeRow(entry->row());
@@ -226,6 +407,8 @@ HistoryModel::Entry* HistoryModel::addEntry(const QUrl &url, const QString &titl
 
 	m_identifiers[identifier] = entry;
 
+	addRecord(AddRecord, entry);
+
 	blockSignals(false);
 
 	emit entryAdded(entry);
@@ -269,52 +452,89 @@ QDateTime HistoryModel::getLastVisitTime(const QUrl &url) const
 	return lastVisitTime;
 }
 
-QVector<HistoryModel::HistoryEntryMatch> HistoryModel::findEntries(const QString &prefix, bool markAsTypedIn) const
+QVector<HistoryModel::HistoryEntryMatch> HistoryModel::findEntries(const QString &prefix, bool markAsTypedIn, int limit) const
 {
-	QVector<Entry*> matchedEntries;
-	QVector<HistoryEntryMatch> allMatches;
-	QVector<HistoryEntryMatch> currentMatches;
-	QMultiMap<QDateTime, HistoryEntryMatch> matchesMap;
-	QHash<QUrl, QVector<Entry*> >::const_iterator urlsIterator;
+	QVector<HistoryEntryMatch> matches;
+	const int matchesAmount(m_completionIndex.getMatchesAmount(prefix));
 
-	for (urlsIterator = m_urls.constBegin(); urlsIterator != m_urls.constEnd(); ++urlsIterator)
+	if (matchesAmount == 0)
 	{
-		if (urlsIterator.value().isEmpty() || matchedEntries.contains(urlsIterator.value().value(0)))
-		{
-			continue;
-		}
+		return matches;
+	}
 
-		const QString result(Utils::matchUrl(urlsIterator.key(), prefix));
+	if (limit > 0 && (static_cast<qint64>(limit) * rowCount()) < (static_cast<qint64>(matchesAmount) * matchesAmount))
+	{
+		QSet<QUrl> urls;
 
-		if (!result.isEmpty())
+		for (int i = 0; (i < rowCount() && matches.count() < limit); ++i)
 		{
-			HistoryEntryMatch match;
-			match.entry = urlsIterator.value().value(0);
-			match.match = result;
+			Entry *entry(static_cast<Entry*>(item(i, 0)));
+			const QUrl url(Utils::normalizeUrl(entry->getUrl()));
 
-			if (markAsTypedIn)
+			if (urls.contains(url))
 			{
-				match.isTypedIn = true;
+				continue;
 			}
 
-			matchesMap.insert(match.entry->data(TimeVisitedRole).toDateTime(), match);
+			urls.insert(url);
+
+			const QString result(Utils::matchUrl(url, prefix));
+
+			if (!result.isEmpty())
+			{
+				HistoryEntryMatch match;
+				match.entry = entry;
+				match.match = result;
+				match.isTypedIn = markAsTypedIn;
 
-			matchedEntries.append(match.entry);
+				matches.append(match);
+			}
 		}
+
+		return matches;
 	}
 
-	currentMatches = matchesMap.values().toVector();
+	const QVector<QUrl> urls(m_completionIndex.findUrls(prefix));
+
+	matches.reserve(urls.count());
+
+	for (int i = 0; i < urls.count(); ++i)
+	{
+		const QString result(Utils::matchUrl(urls.at(i), prefix));
+		const QVector<Entry*> entries(m_urls.value(urls.at(i)));
 
-	matchesMap.clear();
+		if (result.isEmpty() || entries.isEmpty())
+		{
+			continue;
+		}
 
-	allMatches.reserve(currentMatches.count());
+		HistoryEntryMatch match;
+		match.entry = entries.first();
+		match.match = result;
+		match.isTypedIn = markAsTypedIn;
 
-	for (int i = (currentMatches.count() - 1); i >= 0; --i)
+		for (int j = 1; j < entries.count(); ++j)
+		{
+			if (entries.at(j)->getTimeVisited() > match.entry->getTimeVisited())
+			{
+				match.entry = entries.at(j);
+			}
+		}
+
+		matches.append(match);
+	}
+
+	std::stable_sort(matches.begin(), matches.end(), [&](const HistoryEntryMatch &first, const HistoryEntryMatch &second)
+	{
+		return (first.entry->getTimeVisited() > second.entry->getTimeVisited());
+	});
+
+	if (limit > 0 && matches.count() > limit)
 	{
-		allMatches.append(currentMatches.at(i));
+		matches.resize(limit);
 	}
 
-	return allMatches;
+	return matches;
 }
 
 HistoryModel::HistoryType HistoryModel::getType() const
@@ -322,29 +542,168 @@ HistoryModel::HistoryType HistoryModel::getType() const
 	return m_type;
 }
 
-bool HistoryModel::save(const QString &path) const
+QString HistoryModel::getJournalPath(const QString &path)
+{
+	return path + QLatin1String(".journal");
+}
+
+bool HistoryModel::save(const QString &path)
 {
 	if (SessionsManager::isReadOnly())
 	{
 		return false;
 	}
 
-	QJsonArray historyArray;
+	const QString journalPath(getJournalPath(path));
+
+	if (!m_pendingRecords.isEmpty())
+	{
+		if (!writeJournal(journalPath, m_pendingRecords))
+		{
+			Console::addMessage(tr("Failed to save history journal"), Console::OtherCategory, Console::ErrorLevel, journalPath);
+
+			return false;
+		}
+
+		m_journalRecordsAmount += m_pendingRecords.count();
+
+		m_pendingRecords.clear();
+	}
+
+	if (m_isCompacting || (!m_needsCompaction && m_journalRecordsAmount < qMax(HISTORY_JOURNAL_LIMIT, rowCount())))
+	{
+		return true;
+	}
+
+	const QString compactedJournalPath(journalPath + QLatin1String(".old"));
+
+	if (QFile::exists(journalPath))
+	{
+		if (QFile::exists(compactedJournalPath))
+		{
+			QFile journalFile(journalPath);
+			QFile compactedJournalFile(compactedJournalPath);
+
+			if (!journalFile.open(QIODevice::ReadOnly) || !compactedJournalFile.open(QIODevice::WriteOnly | QIODevice::Append))
+			{
+				return true;
+			}
+
+			journalFile.seek(sizeof(quint32) * 2);
+
+			if (compactedJournalFile.write(journalFile.readAll()) < 0)
+			{
+				return true;
+			}
+
+			compactedJournalFile.close();
+			journalFile.close();
+			journalFile.remove();
+		}
+		else if (!QFile::rename(journalPath, compactedJournalPath))
+		{
+			return true;
+		}
+	}
+
+	QVector<Record> records;
+	records.reserve(rowCount());
 
-	for (int i = 0; i < rowCount(); ++i)
+	for (int i = (rowCount() - 1); i >= 0; --i)
 	{
 		const QModelIndex index(this->index(i, 0));
 
 		if (index.isValid())
 		{
-			historyArray.prepend(QJsonObject({{QLatin1String("url"), index.data(UrlRole).toUrl().toString()}, {QLatin1String("title"), index.data(TitleRole).toString()}, {QLatin1String("time"), index.data(TimeVisitedRole).toDateTime().toString(Qt::ISODate)}}));
+			Record record;
+			record.url = index.data(UrlRole).toUrl();
+			record.title = index.data(TitleRole).toString();
+			record.timeVisited = index.data(TimeVisitedRole).toDateTime();
+			record.identifier = index.data(IdentifierRole).toULongLong();
+
+			records.append(record);
 		}
 	}
 
-	JsonSettings settings;
-	settings.setArray(historyArray);
+	m_journalRecordsAmount = 0;
+	m_isCompacting = true;
+	m_needsCompaction = false;
+
+	QFutureWatcher<bool> *watcher(new QFutureWatcher<bool>(this));
+
+	connect(watcher, &QFutureWatcher<bool>::finished, this, [=]()
+	{
+		m_isCompacting = false;
+
+		if (!watcher->result())
+		{
+			Console::addMessage(tr("Failed to save history file"), Console::OtherCategory, Console::ErrorLevel, path);
+		}
+
+		watcher->deleteLater();
 
-	return settings.save(path);
+		if (m_needsCompaction)
+		{
+			save(path);
+		}
+	});
+
+	watcher->setFuture(QtConcurrent::run([=]()
+	{
+		return (writeSnapshot(path, records) && (!QFile::exists(compactedJournalPath) || QFile::remove(compactedJournalPath)));
+	}));
+
+	return true;
+}
+
+bool HistoryModel::writeJournal(const QString &path, const QVector<Record> &records)
+{
+	QFile file(path);
+
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Append))
+	{
+		return false;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_6);
+
+	if (file.size() == 0)
+	{
+		stream << static_cast<quint32>(HISTORY_JOURNAL_MAGIC) << static_cast<quint32>(HISTORY_JOURNAL_VERSION);
+	}
+
+	for (int i = 0; i < records.count(); ++i)
+	{
+		const Record &record(records.at(i));
+
+		stream << static_cast<quint8>(record.type) << record.identifier << record.url.toString() << record.title << record.timeVisited;
+	}
+
+	return (stream.status() == QDataStream::Ok && file.flush());
+}
+
+bool HistoryModel::writeSnapshot(const QString &path, const QVector<Record> &records)
+{
+	QJsonArray historyArray;
+
+	for (int i = 0; i < records.count(); ++i)
+	{
+		const Record &record(records.at(i));
+
+		historyArray.append(QJsonObject({{QLatin1String("identifier"), static_cast<qint64>(record.identifier)}, {QLatin1String("url"), record.url.toString()}, {QLatin1String("title"), record.title}, {QLatin1String("time"), record.timeVisited.toString(Qt::ISODate)}}));
+	}
+
+	QSaveFile file(path);
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		return false;
+	}
+
+	file.write(QJsonDocument(historyArray).toJson(QJsonDocument::Compact));
+
+	return file.commit();
 }
 
 bool HistoryModel::setData(const QModelIndex &index, const QVariant &value, int role)
@@ -368,6 +727,7 @@ bool HistoryModel::setData(const QModelIndex &index, const QVariant &value, int
 			if (m_urls[oldUrl].isEmpty())
 			{
 				m_urls.remove(oldUrl);
+				m_completionIndex.removeUrl(oldUrl);
 			}
 		}
 
@@ -376,6 +736,8 @@ bool HistoryModel::setData(const QModelIndex &index, const QVariant &value, int
 			if (!m_urls.contains(newUrl))
 			{
 				m_urls[newUrl] = QVector<Entry*>();
+
+				m_completionIndex.addUrl(newUrl);
 			}
 
 			m_urls[newUrl].append(entry);
@@ -388,8 +750,17 @@ bool HistoryModel::setData(const QModelIndex &index, const QVariant &value, int
 	{
 		case TitleRole:
 		case UrlRole:
-		case IdentifierRole:
 		case TimeVisitedRole:
+			if (entry->getIdentifier() > 0)
+			{
+				addRecord(ModifyRecord, entry);
+			}
+
+			emit entryModified(entry);
+			emit modelModified();
+
+			break;
+		case IdentifierRole:
 			emit entryModified(entry);
 			emit modelModified();
 
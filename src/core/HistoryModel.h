@@ -21,6 +21,8 @@
 #ifndef OTTER_HISTORYMODEL_H
 #define OTTER_HISTORYMODEL_H
 
+#include "CompletionIndex.h"
+
 #include <QtCore/QDateTime>
 #include <QtCore/QUrl>
 #include <QtGui/QStandardItemModel>
@@ -80,16 +82,47 @@ public:
 	Entry* addEntry(const QUrl &url, const QString &title, const QIcon &icon, const QDateTime &date = QDateTime::currentDateTimeUtc(), quint64 identifier = 0);
 	Entry* getEntry(quint64 identifier) const;
 	QDateTime getLastVisitTime(const QUrl &url) const;
-	QVector<HistoryEntryMatch> findEntries(const QString &prefix, bool markAsTypedIn = false) const;
+	QVector<HistoryEntryMatch> findEntries(const QString &prefix, bool markAsTypedIn = false, int limit = 0) const;
 	HistoryType getType() const;
 	bool hasEntry(const QUrl &url) const;
-	bool save(const QString &path) const;
+	bool save(const QString &path);
 	bool setData(const QModelIndex &index, const QVariant &value, int role) override;
 
+protected:
+	enum RecordType
+	{
+		AddRecord = 1,
+		ModifyRecord,
+		RemoveRecord,
+		ClearRecord
+	};
+
+	struct Record final
+	{
+		QUrl url;
+		QString title;
+		QDateTime timeVisited;
+		quint64 identifier = 0;
+		RecordType type = AddRecord;
+	};
+
+	void loadSnapshot(const QString &path);
+	void loadJournal(const QString &path);
+	void addRecord(RecordType type, Entry *entry);
+	static QString getJournalPath(const QString &path);
+	static bool writeJournal(const QString &path, const QVector<Record> &records);
+	static bool writeSnapshot(const QString &path, const QVector<Record> &records);
+
 private:
 	QHash<QUrl, QVector<Entry*> > m_urls;
 	QMap<quint64, Entry*> m_identifiers;
+	QVector<Record> m_pendingRecords;
+	CompletionIndex m_completionIndex;
 	HistoryType m_type;
+	int m_journalRecordsAmount;
+	bool m_isCompacting;
+	bool m_isLoading;
+	bool m_needsCompaction;
 
 signals:
 	void cleared();
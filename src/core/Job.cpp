@@ -79,7 +79,7 @@ void FetchJob::start()
 		return;
 	}
 
-	m_reply = NetworkManagerFactory::createRequest(m_url, QNetworkAccessManager::GetOperation, m_isPrivate);
+	m_reply = NetworkManagerFactory::createRequest(m_url, QNetworkAccessManager::GetOperation, m_isPrivate, nullptr, m_headers);
 
 	connect(m_reply, &QNetworkReply::downloadProgress, this, [&](qint64 bytesReceived, qint64 bytesTotal)
 	{
@@ -131,6 +131,11 @@ void FetchJob::markAsFinished()
 	m_isFinished = true;
 }
 
+void FetchJob::setHeader(const QByteArray &header, const QByteArray &value)
+{
+	m_headers[header] = value;
+}
+
 void FetchJob::setTimeout(int seconds)
 {
 	if (m_timeoutTimer != 0)
@@ -191,6 +196,11 @@ QMap<QByteArray, QByteArray> DataFetchJob::getHeaders() const
 	return headers;
 }
 
+bool DataFetchJob::isModified() const
+{
+	return (!m_reply || (m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() != 304 && !m_reply->attribute(QNetworkRequest::SourceIsFromCacheAttribute).toBool()));
+}
+
 IconFetchJob::IconFetchJob(const QUrl &url, QObject *parent) : FetchJob(url, parent)
 {
 	setSizeLimit(20480);
@@ -59,6 +59,7 @@ public:
 	explicit FetchJob(const QUrl &url, QObject *parent = nullptr);
 	~FetchJob();
 
+	void setHeader(const QByteArray &header, const QByteArray &value);
 	void setTimeout(int seconds);
 	void setSizeLimit(qint64 limit);
 	void setPrivate(bool isPrivate);
@@ -78,6 +79,7 @@ protected:
 private:
 	QNetworkReply *m_reply;
 	QUrl m_url;
+	QMap<QByteArray, QByteArray> m_headers;
 	qint64 m_sizeLimit;
 	int m_timeoutTimer;
 	bool m_isFinished;
@@ -94,6 +96,7 @@ public:
 
 	QIODevice* getData() const;
 	QMap<QByteArray, QByteArray> getHeaders() const;
+	bool isModified() const;
 
 protected:
 	void handleSuccessfulReply(QNetworkReply *reply) override;
@@ -92,6 +92,11 @@ void LongTermTimer::updateTimer(quint64 remainingTime, bool updateCounter)
 		m_remainingTime = (remainingTime - timerValue);
 	}
 
+	if (m_timer > 0)
+	{
+		killTimer(m_timer);
+	}
+
 	m_timer = startTimer(static_cast<int>(timerValue));
 }
 
@@ -216,6 +216,8 @@ public:
 
 	void migrate() const override
 	{
+		SettingsManager::synchronize();
+
 		QMap<QString, SettingsManager::OptionIdentifier> optionsMap;
 		optionsMap[QLatin1String("Browser/DelayRestoringOfBackgroundTabs")] = SettingsManager::Sessions_DeferTabsLoadingOption;
 		optionsMap[QLatin1String("Browser/EnableFullScreen")] = SettingsManager::Permissions_EnableFullScreenOption;
@@ -274,6 +276,11 @@ public:
 			overrides.endGroup();
 		}
 
+		configuration.sync();
+		overrides.sync();
+
+		SettingsManager::reload();
+
 		const QStringList sessions(SessionsManager::getSessions());
 
 		for (int i = 0; i < sessions.count(); ++i)
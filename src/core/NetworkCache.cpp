@@ -21,13 +21,38 @@
 #include "SessionsManager.h"
 #include "SettingsManager.h"
 
-#include <QtCore/QDateTime>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
 #include <QtCore/QDir>
+#include <QtCore/QDirIterator>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QMimeDatabase>
+#include <QtCore/QSaveFile>
+#include <QtCore/QTimerEvent>
+
+#define CACHE_FILE_MAGIC 0xe8
+#define CACHE_FILE_VERSION 8
+#define EVICTION_BATCH_SIZE 50
+#define EVICTION_HOST_QUOTA 25
+#define EVICTION_INTERVAL 100
+#define EVICTION_PROTECTED_HITS 2
+#define EVICTION_TARGET 90
+#define INDEX_MAGIC 0x4F4E4349
+#define INDEX_SAVE_INTERVAL 60000
+#define INDEX_VERSION 2
 
 namespace Otter
 {
 
-NetworkCache::NetworkCache(QObject *parent) : QNetworkDiskCache(parent)
+NetworkCache::NetworkCache(QObject *parent) : QNetworkDiskCache(parent),
+	m_rebuildWatcher(nullptr),
+	m_cacheSize(0),
+	m_evictionTimer(0),
+	m_saveTimer(0),
+	m_isIndexValid(false),
+	m_isIndexModified(false)
 {
 	const QString cachePath(SessionsManager::getCachePath());
 
@@ -37,11 +62,43 @@ NetworkCache::NetworkCache(QObject *parent) : QNetworkDiskCache(parent)
 
 		setCacheDirectory(cachePath);
 		setMaximumCacheSize(SettingsManager::getOption(SettingsManager::Cache_DiskCacheLimitOption).toInt() * 1024);
+		loadIndex();
+
+		if (!m_isIndexValid)
+		{
+			startIndexRebuild();
+		}
 
 		connect(SettingsManager::getInstance(), &SettingsManager::optionChanged, this, &NetworkCache::handleOptionChanged);
 	}
 }
 
+NetworkCache::~NetworkCache()
+{
+	if (m_rebuildWatcher)
+	{
+		m_rebuildWatcher->waitForFinished();
+	}
+
+	saveIndex();
+}
+
+void NetworkCache::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_evictionTimer)
+	{
+		evictEntries();
+	}
+	else if (event->timerId() == m_saveTimer)
+	{
+		killTimer(m_saveTimer);
+
+		m_saveTimer = 0;
+
+		saveIndex();
+	}
+}
+
 void NetworkCache::handleOptionChanged(int identifier, const QVariant &value)
 {
 	if (identifier == SettingsManager::Cache_DiskCacheLimitOption)
@@ -54,51 +111,369 @@ void NetworkCache::clearCache(int period)
 {
 	if (period <= 0)
 	{
+		m_entries.clear();
+		m_evictionQueue.clear();
+
+		m_cacheSize = 0;
+
 		clear();
 
+		m_isIndexValid = true;
+
+		scheduleIndexSave();
+
 		emit cleared();
 
 		return;
 	}
 
+	waitForIndex();
+
 	const QDateTime currentDateTime(QDateTime::currentDateTimeUtc());
-	const QDir cacheMainDirectory(cacheDirectory());
-	const QStringList directories(cacheMainDirectory.entryList(QDir::AllDirs | QDir::NoDotAndDotDot));
+	const QList<EntryInformation> entries(m_entries.values());
 
-	for (int i = 0; i < directories.count(); ++i)
+	for (int i = 0; i < entries.count(); ++i)
 	{
-		const QDir cacheSubDirectory(cacheMainDirectory.absoluteFilePath(directories.at(i)));
-		const QStringList subDirectories(cacheSubDirectory.entryList(QDir::AllDirs | QDir::NoDotAndDotDot));
-
-		for (int j = 0; j < subDirectories.count(); ++j)
+		if (entries.at(i).timeStamp.secsTo(currentDateTime) < (period * 3600))
 		{
-			const QFileInfoList files(QDir(cacheSubDirectory.absoluteFilePath(subDirectories.at(j))).entryInfoList(QDir::Files));
-
-			for (int k = 0; k < files.count(); ++k)
-			{
-				if (files.at(k).lastModified().toUTC().secsTo(currentDateTime) < (period * 3600))
-				{
-					const QNetworkCacheMetaData metaData(fileMetaData(files.at(k).absoluteFilePath()));
-
-					if (metaData.isValid())
-					{
-						remove(metaData.url());
-					}
-				}
-			}
+			remove(entries.at(i).url);
 		}
 	}
 }
 
 void NetworkCache::insert(QIODevice *device)
 {
+	if (!m_devices.contains(device))
+	{
+		QNetworkDiskCache::insert(device);
+
+		return;
+	}
+
+	const QNetworkCacheMetaData metaData(m_devices.take(device));
+
 	QNetworkDiskCache::insert(device);
 
-	if (m_devices.contains(device))
+	if (m_isIndexValid || m_rebuildWatcher)
+	{
+		const EntryInformation previousEntry(m_entries.value(metaData.url()));
+		EntryInformation entry;
+		entry.url = metaData.url();
+		entry.path = getCacheFileName(metaData.url());
+		entry.mimeType = getMimeType(metaData);
+		entry.lastModified = metaData.lastModified();
+		entry.expirationDate = metaData.expirationDate();
+		entry.timeStamp = QDateTime::currentDateTimeUtc();
+		entry.lastAccess = entry.timeStamp;
+		entry.size = (entry.path.isEmpty() ? -1 : QFileInfo(entry.path).size());
+		entry.hits = previousEntry.hits;
+
+		m_entries[entry.url] = entry;
+
+		m_cacheSize += (qMax(entry.size, static_cast<qint64>(0)) - qMax(previousEntry.size, static_cast<qint64>(0)));
+
+		scheduleIndexSave();
+		scheduleEviction();
+	}
+
+	emit entryAdded(metaData.url());
+}
+
+void NetworkCache::loadIndex()
+{
+	QFile file(getIndexPath());
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_6);
+
+	quint32 magic(0);
+	quint32 version(0);
+	quint32 amount(0);
+
+	stream >> magic >> version >> amount;
+
+	if (magic != INDEX_MAGIC || version != INDEX_VERSION)
+	{
+		return;
+	}
+
+	m_entries.reserve(static_cast<int>(amount));
+
+	for (quint32 i = 0; i < amount; ++i)
+	{
+		EntryInformation entry;
+
+		stream >> entry.url >> entry.path >> entry.mimeType >> entry.lastModified >> entry.expirationDate >> entry.timeStamp >> entry.lastAccess >> entry.size >> entry.hits;
+
+		if (stream.status() != QDataStream::Ok)
+		{
+			m_entries.clear();
+
+			m_cacheSize = 0;
+
+			return;
+		}
+
+		m_entries[entry.url] = entry;
+
+		m_cacheSize += qMax(entry.size, static_cast<qint64>(0));
+	}
+
+	m_isIndexValid = true;
+}
+
+void NetworkCache::startIndexRebuild()
+{
+	if (m_rebuildWatcher)
+	{
+		return;
+	}
+
+	m_rebuildWatcher = new QFutureWatcher<QHash<QUrl, EntryInformation> >(this);
+
+	connect(m_rebuildWatcher, &QFutureWatcher<QHash<QUrl, EntryInformation> >::finished, this, &NetworkCache::handleIndexRebuilt);
+
+	const QString directory(cacheDirectory());
+
+	m_rebuildWatcher->setFuture(QtConcurrent::run([=]()
+	{
+		return scanEntries(directory);
+	}));
+}
+
+void NetworkCache::waitForIndex()
+{
+	if (m_isIndexValid || cacheDirectory().isEmpty())
+	{
+		return;
+	}
+
+	if (!m_rebuildWatcher)
+	{
+		startIndexRebuild();
+	}
+
+	disconnect(m_rebuildWatcher, &QFutureWatcher<QHash<QUrl, EntryInformation> >::finished, this, &NetworkCache::handleIndexRebuilt);
+
+	m_rebuildWatcher->waitForFinished();
+
+	handleIndexRebuilt();
+}
+
+void NetworkCache::handleIndexRebuilt()
+{
+	const QHash<QUrl, EntryInformation> entries(m_rebuildWatcher->result());
+
+	m_rebuildWatcher->deleteLater();
+	m_rebuildWatcher = nullptr;
+
+	if (m_isIndexValid)
+	{
+		m_removedEntries.clear();
+
+		return;
+	}
+
+	QHash<QUrl, EntryInformation>::const_iterator iterator;
+
+	for (iterator = entries.constBegin(); iterator != entries.constEnd(); ++iterator)
+	{
+		if (!m_entries.contains(iterator.key()) && !m_removedEntries.contains(iterator.key()))
+		{
+			m_entries[iterator.key()] = iterator.value();
+
+			m_cacheSize += qMax(iterator.value().size, static_cast<qint64>(0));
+		}
+	}
+
+	m_removedEntries.clear();
+
+	m_isIndexValid = true;
+
+	scheduleIndexSave();
+	scheduleEviction();
+}
+
+void NetworkCache::saveIndex()
+{
+	if (!m_isIndexValid || !m_isIndexModified || cacheDirectory().isEmpty())
+	{
+		return;
+	}
+
+	QSaveFile file(getIndexPath());
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		return;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_6);
+	stream << static_cast<quint32>(INDEX_MAGIC) << static_cast<quint32>(INDEX_VERSION) << static_cast<quint32>(m_entries.count());
+
+	QHash<QUrl, EntryInformation>::const_iterator iterator;
+
+	for (iterator = m_entries.constBegin(); iterator != m_entries.constEnd(); ++iterator)
+	{
+		const EntryInformation entry(iterator.value());
+
+		stream << entry.url << entry.path << entry.mimeType << entry.lastModified << entry.expirationDate << entry.timeStamp << entry.lastAccess << entry.size << entry.hits;
+	}
+
+	if (file.commit())
+	{
+		m_isIndexModified = false;
+	}
+}
+
+void NetworkCache::scheduleIndexSave()
+{
+	if (!m_isIndexModified)
+	{
+		QFile::remove(getIndexPath());
+
+		m_isIndexModified = true;
+	}
+
+	if (m_saveTimer == 0)
+	{
+		m_saveTimer = startTimer(INDEX_SAVE_INTERVAL);
+	}
+}
+
+void NetworkCache::scheduleEviction()
+{
+	if (m_isIndexValid && m_evictionTimer == 0 && maximumCacheSize() > 0 && m_cacheSize > maximumCacheSize())
+	{
+		m_evictionTimer = startTimer(EVICTION_INTERVAL);
+	}
+}
+
+void NetworkCache::evictEntries()
+{
+	const qint64 targetSize(maximumCacheSize() * EVICTION_TARGET / 100);
+
+	if (m_evictionQueue.isEmpty() && m_cacheSize > targetSize)
+	{
+		createEvictionQueue(m_cacheSize - targetSize);
+	}
+
+	int amount(0);
+
+	while (!m_evictionQueue.isEmpty() && amount < EVICTION_BATCH_SIZE && m_cacheSize > targetSize)
+	{
+		const QUrl url(m_evictionQueue.dequeue());
+
+		if (m_entries.contains(url))
+		{
+			remove(url);
+
+			++amount;
+		}
+	}
+
+	if (m_cacheSize <= targetSize || (amount == 0 && m_evictionQueue.isEmpty()))
+	{
+		killTimer(m_evictionTimer);
+
+		m_evictionTimer = 0;
+
+		m_evictionQueue.clear();
+	}
+}
+
+void NetworkCache::createEvictionQueue(qint64 requiredSize)
+{
+	const qint64 hostQuota(maximumCacheSize() * EVICTION_HOST_QUOTA / 100);
+	QVector<EntryInformation> entries;
+	entries.reserve(m_entries.count());
+
+	QHash<QString, qint64> hostSizes;
+	QHash<QUrl, EntryInformation>::const_iterator iterator;
+
+	for (iterator = m_entries.constBegin(); iterator != m_entries.constEnd(); ++iterator)
+	{
+		entries.append(iterator.value());
+
+		hostSizes[iterator.key().host()] += qMax(iterator.value().size, static_cast<qint64>(0));
+	}
+
+	std::sort(entries.begin(), entries.end(), [&](const EntryInformation &first, const EntryInformation &second)
+	{
+		const bool isFirstProtected(first.hits >= EVICTION_PROTECTED_HITS);
+		const bool isSecondProtected(second.hits >= EVICTION_PROTECTED_HITS);
+
+		if (isFirstProtected != isSecondProtected)
+		{
+			return isSecondProtected;
+		}
+
+		return (first.lastAccess < second.lastAccess);
+	});
+
+	QVector<bool> isQueued(entries.count(), false);
+	qint64 queuedSize(0);
+
+	for (int i = 0; i < entries.count(); ++i)
+	{
+		const QString host(entries.at(i).url.host());
+		const qint64 size(qMax(entries.at(i).size, static_cast<qint64>(0)));
+
+		if (hostSizes.value(host) > hostQuota)
+		{
+			m_evictionQueue.enqueue(entries.at(i).url);
+
+			hostSizes[host] -= size;
+			queuedSize += size;
+
+			isQueued[i] = true;
+		}
+	}
+
+	for (int i = 0; (i < entries.count() && queuedSize < requiredSize); ++i)
+	{
+		if (!isQueued.at(i))
+		{
+			m_evictionQueue.enqueue(entries.at(i).url);
+
+			queuedSize += qMax(entries.at(i).size, static_cast<qint64>(0));
+		}
+	}
+}
+
+void NetworkCache::removeEntry(const QUrl &url)
+{
+	if (m_rebuildWatcher && !m_isIndexValid)
 	{
-		emit entryAdded(m_devices[device]);
+		m_removedEntries.insert(url);
+	}
+
+	if (m_entries.contains(url))
+	{
+		m_cacheSize -= qMax(m_entries.take(url).size, static_cast<qint64>(0));
 
-		m_devices.remove(device);
+		scheduleIndexSave();
+	}
+}
+
+void NetworkCache::validateEntries()
+{
+	const QList<EntryInformation> entries(m_entries.values());
+
+	for (int i = 0; i < entries.count(); ++i)
+	{
+		if (entries.at(i).path.isEmpty() ? !metaData(entries.at(i).url).isValid() : !QFile::exists(entries.at(i).path))
+		{
+			removeEntry(entries.at(i).url);
+
+			emit entryRemoved(entries.at(i).url);
+		}
 	}
 }
 
@@ -108,87 +483,265 @@ QIODevice* NetworkCache::prepare(const QNetworkCacheMetaData &metaData)
 
 	if (device)
 	{
-		m_devices[device] = metaData.url();
+		m_devices[device] = metaData;
+	}
+
+	return device;
+}
+
+QIODevice* NetworkCache::data(const QUrl &url)
+{
+	QIODevice *device(QNetworkDiskCache::data(url));
+
+	if (device && (m_isIndexValid || m_rebuildWatcher) && m_entries.contains(url))
+	{
+		EntryInformation &entry(m_entries[url]);
+		entry.lastAccess = QDateTime::currentDateTimeUtc();
+
+		++entry.hits;
 	}
 
 	return device;
 }
 
+QString NetworkCache::getIndexPath() const
+{
+	return QDir(cacheDirectory()).filePath(QLatin1String("index.dat"));
+}
+
+QString NetworkCache::getCacheFileName(const QUrl &url) const
+{
+	QUrl cleanUrl(url);
+	cleanUrl.setPassword({});
+	cleanUrl.setFragment({});
+
+	const QByteArray hash(QCryptographicHash::hash(cleanUrl.toEncoded(), QCryptographicHash::Sha1));
+	qlonglong value(0);
+
+	memcpy(&value, hash.constData(), sizeof(qlonglong));
+
+	const QByteArray identifier(QByteArray::number(value, 36).left(8));
+
+	return QDir(cacheDirectory()).filePath(QStringLiteral("data%1/").arg(CACHE_FILE_VERSION) + QString::number((static_cast<uint>(identifier.at(identifier.length() - 1)) % 16), 16) + QLatin1Char('/') + QLatin1String(identifier) + QLatin1String(".d"));
+}
+
+QString NetworkCache::findCacheFile(const QUrl &url) const
+{
+	const QString path(getCacheFileName(url));
+
+	if (QFile::exists(path) && fileMetaData(path).url() == url)
+	{
+		return path;
+	}
+
+	QDirIterator iterator(cacheDirectory(), {QLatin1String("*.d")}, QDir::Files, QDirIterator::Subdirectories);
+
+	while (iterator.hasNext())
+	{
+		const QString cacheFilePath(iterator.next());
+
+		if (fileMetaData(cacheFilePath).url() == url)
+		{
+			return cacheFilePath;
+		}
+	}
+
+	return {};
+}
+
+QNetworkCacheMetaData NetworkCache::readMetaData(const QString &path)
+{
+	QFile file(path);
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return {};
+	}
+
+	QDataStream stream(&file);
+	qint32 magic(0);
+	qint32 version(0);
+	qint32 streamVersion(0);
+
+	stream >> magic >> version >> streamVersion;
+
+	if (stream.status() != QDataStream::Ok || magic != CACHE_FILE_MAGIC || version != CACHE_FILE_VERSION || streamVersion > stream.version())
+	{
+		return {};
+	}
+
+	stream.setVersion(streamVersion);
+
+	QNetworkCacheMetaData metaData;
+
+	stream >> metaData;
+
+	return ((stream.status() == QDataStream::Ok) ? metaData : QNetworkCacheMetaData());
+}
+
+QHash<QUrl, NetworkCache::EntryInformation> NetworkCache::scanEntries(const QString &directory)
+{
+	QHash<QUrl, EntryInformation> entries;
+	QDirIterator iterator(directory, {QLatin1String("*.d")}, QDir::Files, QDirIterator::Subdirectories);
+
+	while (iterator.hasNext())
+	{
+		const QString path(iterator.next());
+		const QNetworkCacheMetaData metaData(readMetaData(path));
+
+		if (!metaData.isValid() || !metaData.url().isValid())
+		{
+			continue;
+		}
+
+		EntryInformation entry;
+		entry.url = metaData.url();
+		entry.path = path;
+		entry.mimeType = getMimeType(metaData);
+		entry.lastModified = metaData.lastModified();
+		entry.expirationDate = metaData.expirationDate();
+		entry.timeStamp = iterator.fileInfo().lastModified().toUTC();
+		entry.lastAccess = entry.timeStamp;
+		entry.size = iterator.fileInfo().size();
+
+		entries[entry.url] = entry;
+	}
+
+	return entries;
+}
+
 QString NetworkCache::getPathForUrl(const QUrl &url)
 {
-	if (!url.isValid() || !metaData(url).isValid())
+	if (!url.isValid())
 	{
 		return {};
 	}
 
-	const QDir cacheMainDirectory(cacheDirectory());
-	const QStringList directories(cacheMainDirectory.entryList(QDir::AllDirs | QDir::NoDotAndDotDot));
+	waitForIndex();
 
-	for (int i = 0; i < directories.count(); ++i)
+	if (!m_entries.contains(url))
 	{
-		const QDir cacheSubDirectory(cacheMainDirectory.absoluteFilePath(directories.at(i)));
-		const QStringList subDirectories(cacheSubDirectory.entryList(QDir::AllDirs | QDir::NoDotAndDotDot));
+		return {};
+	}
+
+	EntryInformation &entry(m_entries[url]);
+
+	if (entry.path.isEmpty() || !QFile::exists(entry.path))
+	{
+		entry.path = findCacheFile(url);
+
+		if (entry.path.isEmpty())
+		{
+			removeEntry(url);
+
+			return {};
+		}
+
+		scheduleIndexSave();
+	}
+
+	return entry.path;
+}
 
-		for (int j = 0; j < subDirectories.count(); ++j)
+QString NetworkCache::getMimeType(const QNetworkCacheMetaData &metaData)
+{
+	const QList<QPair<QByteArray, QByteArray> > headers(metaData.rawHeaders());
+
+	for (int i = 0; i < headers.count(); ++i)
+	{
+		if (headers.at(i).first.toLower() == QByteArrayLiteral("content-type"))
 		{
-			const QDir cacheFilesDirectory(cacheSubDirectory.absoluteFilePath(subDirectories.at(j)));
-			const QStringList files(cacheFilesDirectory.entryList(QDir::Files));
-
-			for (int k = 0; k < files.count(); ++k)
-			{
-				const QString cacheFilePath(cacheFilesDirectory.absoluteFilePath(files.at(k)));
-				const QNetworkCacheMetaData metaData(fileMetaData(cacheFilePath));
-
-				if (metaData.isValid() && url == metaData.url())
-				{
-					return cacheFilePath;
-				}
-			}
+			return QString::fromLatin1(headers.at(i).second).section(QLatin1Char(';'), 0, 0).trimmed();
 		}
 	}
 
 	return {};
 }
 
-QVector<QUrl> NetworkCache::getEntries() const
+QString NetworkCache::sniffMimeType(const QUrl &url)
 {
-	QVector<QUrl> entries;
-	const QDir cacheMainDirectory(cacheDirectory());
-	const QStringList directories(cacheMainDirectory.entryList(QDir::AllDirs | QDir::NoDotAndDotDot));
+	waitForIndex();
+
+	if (!m_entries.contains(url))
+	{
+		return {};
+	}
 
-	for (int i = 0; i < directories.count(); ++i)
+	EntryInformation &entry(m_entries[url]);
+
+	if (entry.mimeType.isEmpty())
 	{
-		const QDir cacheSubDirectory(cacheMainDirectory.absoluteFilePath(directories.at(i)));
-		const QStringList subDirectories(cacheSubDirectory.entryList(QDir::AllDirs | QDir::NoDotAndDotDot));
+		QIODevice *device(QNetworkDiskCache::data(url));
 
-		for (int j = 0; j < subDirectories.count(); ++j)
+		if (!device)
 		{
-			const QDir cacheFilesDirectory(cacheSubDirectory.absoluteFilePath(subDirectories.at(j)));
-			const QStringList files(cacheFilesDirectory.entryList(QDir::Files));
+			return {};
+		}
 
-			entries.reserve(entries.count() + files.count());
+		entry.mimeType = QMimeDatabase().mimeTypeForData(device).name();
 
-			for (int k = 0; k < files.count(); ++k)
-			{
-				const QNetworkCacheMetaData metaData(fileMetaData(cacheFilesDirectory.absoluteFilePath(files.at(k))));
+		device->deleteLater();
 
-				if (metaData.url().isValid())
-				{
-					entries.append(metaData.url());
-				}
-			}
-		}
+		scheduleIndexSave();
 	}
 
-	entries.squeeze();
+	return entry.mimeType;
+}
+
+NetworkCache::EntryInformation NetworkCache::getEntry(const QUrl &url)
+{
+	waitForIndex();
+
+	return m_entries.value(url);
+}
+
+QVector<QUrl> NetworkCache::getEntries()
+{
+	waitForIndex();
+
+	QVector<QUrl> entries;
+	entries.reserve(m_entries.count());
+
+	QHash<QUrl, EntryInformation>::const_iterator iterator;
+
+	for (iterator = m_entries.constBegin(); iterator != m_entries.constEnd(); ++iterator)
+	{
+		entries.append(iterator.key());
+	}
 
 	return entries;
 }
 
+qint64 NetworkCache::expire()
+{
+	if (m_rebuildWatcher && !m_isIndexValid && maximumCacheSize() > 0)
+	{
+		return m_cacheSize;
+	}
+
+	if (!m_isIndexValid || maximumCacheSize() <= 0)
+	{
+		const qint64 size(QNetworkDiskCache::expire());
+
+		if (m_isIndexValid)
+		{
+			validateEntries();
+		}
+
+		return size;
+	}
+
+	scheduleEviction();
+
+	return m_cacheSize;
+}
+
 bool NetworkCache::remove(const QUrl &url)
 {
 	const bool result(QNetworkDiskCache::remove(url));
 
+	removeEntry(url);
+
 	if (result)
 	{
 		emit entryRemoved(url);
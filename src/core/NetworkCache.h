@@ -20,6 +20,10 @@
 #ifndef OTTER_NETWORKCACHE_H
 #define OTTER_NETWORKCACHE_H
 
+#include <QtCore/QDateTime>
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QQueue>
+#include <QtCore/QSet>
 #include <QtNetwork/QNetworkDiskCache>
 
 namespace Otter
@@ -30,20 +34,67 @@ class NetworkCache final : public QNetworkDiskCache
 	Q_OBJECT
 
 public:
+	struct EntryInformation final
+	{
+		QUrl url;
+		QString path;
+		QString mimeType;
+		QDateTime lastModified;
+		QDateTime expirationDate;
+		QDateTime timeStamp;
+		QDateTime lastAccess;
+		qint64 size = -1;
+		int hits = 0;
+	};
+
 	explicit NetworkCache(QObject *parent = nullptr);
+	~NetworkCache();
 
 	void clearCache(int period = 0);
 	void insert(QIODevice *device) override;
 	QIODevice* prepare(const QNetworkCacheMetaData &metaData) override;
+	QIODevice* data(const QUrl &url) override;
 	QString getPathForUrl(const QUrl &url);
-	QVector<QUrl> getEntries() const;
+	QString sniffMimeType(const QUrl &url);
+	EntryInformation getEntry(const QUrl &url);
+	QVector<QUrl> getEntries();
 	bool remove(const QUrl &url) override;
 
+protected:
+	void timerEvent(QTimerEvent *event) override;
+	void loadIndex();
+	void startIndexRebuild();
+	void waitForIndex();
+	void saveIndex();
+	void scheduleIndexSave();
+	void scheduleEviction();
+	void evictEntries();
+	void createEvictionQueue(qint64 requiredSize);
+	void removeEntry(const QUrl &url);
+	void validateEntries();
+	QString getIndexPath() const;
+	QString getCacheFileName(const QUrl &url) const;
+	QString findCacheFile(const QUrl &url) const;
+	static QString getMimeType(const QNetworkCacheMetaData &metaData);
+	static QNetworkCacheMetaData readMetaData(const QString &path);
+	static QHash<QUrl, EntryInformation> scanEntries(const QString &directory);
+	qint64 expire() override;
+
 protected slots:
 	void handleOptionChanged(int identifier, const QVariant &value);
+	void handleIndexRebuilt();
 
 private:
-	QHash<QIODevice*, QUrl> m_devices;
+	QFutureWatcher<QHash<QUrl, EntryInformation> > *m_rebuildWatcher;
+	QHash<QIODevice*, QNetworkCacheMetaData> m_devices;
+	QHash<QUrl, EntryInformation> m_entries;
+	QSet<QUrl> m_removedEntries;
+	QQueue<QUrl> m_evictionQueue;
+	qint64 m_cacheSize;
+	int m_evictionTimer;
+	int m_saveTimer;
+	bool m_isIndexValid;
+	bool m_isIndexModified;
 
 signals:
 	void cleared();
@@ -650,12 +650,24 @@ CookieJar* NetworkManagerFactory::getCookieJar()
 	return m_cookieJar;
 }
 
-QNetworkReply* NetworkManagerFactory::createRequest(const QUrl &url, QNetworkAccessManager::Operation operation, bool isPrivate, QIODevice *outgoingData)
+QNetworkReply* NetworkManagerFactory::createRequest(const QUrl &url, QNetworkAccessManager::Operation operation, bool isPrivate, QIODevice *outgoingData, const QMap<QByteArray, QByteArray> &headers)
 {
 	QNetworkRequest request(url);
 	request.setAttribute(QNetworkRequest::FollowRedirectsAttribute, true);
 	request.setHeader(QNetworkRequest::UserAgentHeader, getUserAgent());
 
+	if (headers.contains(QByteArrayLiteral("If-Modified-Since")) || headers.contains(QByteArrayLiteral("If-None-Match")))
+	{
+		request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
+	}
+
+	QMap<QByteArray, QByteArray>::const_iterator iterator;
+
+	for (iterator = headers.constBegin(); iterator != headers.constEnd(); ++iterator)
+	{
+		request.setRawHeader(iterator.key(), iterator.value());
+	}
+
 	return getNetworkManager(isPrivate)->createRequest(operation, request, outgoingData);
 }
 
@@ -25,9 +25,10 @@
 #include "../ui/MainWindow.h"
 #include "../ui/Window.h"
 
+#include <QtConcurrent/QtConcurrentRun>
 #include <QtCore/QDir>
+#include <QtCore/QFutureWatcher>
 #include <QtCore/QJsonArray>
-#include <QtCore/QJsonObject>
 
 namespace Otter
 {
@@ -44,6 +45,8 @@ QString SessionsManager::m_cachePath;
 QString SessionsManager::m_profilePath;
 QHash<QString, Session::Identity> SessionsManager::m_identities;
 QVector<Session::MainWindow> SessionsManager::m_closedWindows;
+QVector<Session::MainWindow> SessionsManager::m_savedWindows;
+QString SessionsManager::m_savedSessionTitle;
 bool SessionsManager::m_isDirty(false);
 bool SessionsManager::m_isPrivate(false);
 bool SessionsManager::m_isReadOnly(false);
@@ -51,6 +54,7 @@ bool SessionsManager::m_isReadOnly(false);
 SessionsManager::SessionsManager(QObject *parent) : QObject(parent),
 	m_saveTimer(0)
 {
+	m_threadPool.setMaxThreadCount(1);
 }
 
 void SessionsManager::timerEvent(QTimerEvent *event)
@@ -65,7 +69,7 @@ void SessionsManager::timerEvent(QTimerEvent *event)
 
 		if (!m_isPrivate)
 		{
-			saveSession({}, {}, nullptr, false);
+			saveSessionInBackground();
 		}
 	}
 }
@@ -90,6 +94,55 @@ void SessionsManager::scheduleSave()
 	}
 }
 
+void SessionsManager::saveSessionInBackground()
+{
+	const QVector<MainWindow*> windows(Application::getWindows());
+	SessionInformation session;
+	session.path = getSessionPath({});
+	session.title = m_sessionTitle;
+	session.isClean = false;
+	session.windows.reserve(windows.count());
+
+	for (int i = 0; i < windows.count(); ++i)
+	{
+		if (!windows.at(i)->isPrivate())
+		{
+			session.windows.append(windows.at(i)->getSession());
+		}
+	}
+
+	if (session.windows.isEmpty() || (session.windows == m_savedWindows && session.title == m_savedSessionTitle))
+	{
+		return;
+	}
+
+	m_savedWindows = session.windows;
+	m_savedSessionTitle = session.title;
+
+	const QString sessionsPath(m_profilePath + QLatin1String("/sessions/"));
+	QFutureWatcher<bool> *watcher(new QFutureWatcher<bool>(this));
+
+	connect(watcher, &QFutureWatcher<bool>::finished, this, [=]()
+	{
+		if (!watcher->result())
+		{
+			m_savedWindows.clear();
+		}
+
+		watcher->deleteLater();
+	});
+
+	watcher->setFuture(QtConcurrent::run(&m_threadPool, [=]()
+	{
+		QDir().mkpath(sessionsPath);
+
+		JsonSettings settings;
+		settings.setObject(createSessionObject(session));
+
+		return settings.save(session.path);
+	}));
+}
+
 void SessionsManager::clearClosedWindows()
 {
 	m_closedWindows.clear();
@@ -653,6 +706,21 @@ bool SessionsManager::saveSession(const SessionInformation &session)
 		}
 	}
 
+	if (m_instance)
+	{
+		m_instance->m_threadPool.waitForDone();
+	}
+
+	m_savedWindows.clear();
+
+	JsonSettings settings;
+	settings.setObject(createSessionObject(session));
+
+	return settings.save(path);
+}
+
+QJsonObject SessionsManager::createSessionObject(const SessionInformation &session)
+{
 	const QStringList excludedOptions(SettingsManager::getOption(SettingsManager::Sessions_OptionsExludedFromSavingOption).toStringList());
 	QJsonArray mainWindowsArray;
 	QJsonObject sessionObject({{QLatin1String("title"), session.title}, {QLatin1String("currentIndex"), 1}});
@@ -844,10 +912,7 @@ bool SessionsManager::saveSession(const SessionInformation &session)
 
 	sessionObject.insert(QLatin1String("windows"), mainWindowsArray);
 
-	JsonSettings settings;
-	settings.setObject(sessionObject);
-
-	return settings.save(path);
+	return sessionObject;
 }
 
 bool SessionsManager::deleteSession(const QString &path)
@@ -27,7 +27,9 @@
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QDateTime>
+#include <QtCore/QJsonObject>
 #include <QtCore/QRect>
+#include <QtCore/QThreadPool>
 
 namespace Otter
 {
@@ -80,6 +82,11 @@ public:
 
 					return title;
 				}
+
+				bool operator==(const Entry &other) const
+				{
+					return (url == other.url && title == other.title && position == other.position && zoom == other.zoom);
+				}
 			};
 
 			QVector<Entry> entries;
@@ -89,12 +96,22 @@ public:
 			{
 				return (entries.isEmpty() || (entries.count() == 1 && Utils::isUrlEmpty(QUrl(entries.value(0).url))));
 			}
+
+			bool operator==(const History &other) const
+			{
+				return (index == other.index && entries == other.entries);
+			}
 		};
 
 		struct State final
 		{
 			QRect geometry;
 			Qt::WindowState state = ((SettingsManager::getOption(SettingsManager::Interface_NewTabOpeningActionOption).toString() == QLatin1String("maximizeTab")) ? Qt::WindowMaximized : Qt::WindowNoState);
+
+			bool operator==(const State &other) const
+			{
+				return (state == other.state && geometry == other.geometry);
+			}
 		};
 
 		QString identity;
@@ -134,6 +151,11 @@ public:
 
 			return SettingsManager::getOption(SettingsManager::Content_DefaultZoomOption).toInt();
 		}
+
+		bool operator==(const Window &other) const
+		{
+			return (identity == other.identity && history == other.history && state == other.state && options == other.options && parentGroup == other.parentGroup && isAlwaysOnTop == other.isAlwaysOnTop && isPinned == other.isPinned);
+		}
 	};
 
 	struct MainWindow final
@@ -185,6 +207,11 @@ public:
 			{
 				return (identifier >= 0);
 			}
+
+			bool operator==(const ToolBarState &other) const
+			{
+				return (location == other.location && identifier == other.identifier && row == other.row && normalVisibility == other.normalVisibility && fullScreenVisibility == other.fullScreenVisibility);
+			}
 		};
 
 		QMap<QString, QVector<int> > splitters;
@@ -193,6 +220,11 @@ public:
 		QByteArray geometry;
 		int index = -1;
 		bool hasToolBarsState = false;
+
+		bool operator==(const MainWindow &other) const
+		{
+			return (index == other.index && hasToolBarsState == other.hasToolBarsState && geometry == other.geometry && windows == other.windows && toolBars == other.toolBars && splitters == other.splitters);
+		}
 	};
 
 	struct ClosedWindow final
@@ -274,8 +306,11 @@ protected:
 
 	void timerEvent(QTimerEvent *event) override;
 	void scheduleSave();
+	void saveSessionInBackground();
+	static QJsonObject createSessionObject(const SessionInformation &session);
 
 private:
+	QThreadPool m_threadPool;
 	int m_saveTimer;
 
 	static SessionsManager *m_instance;
@@ -286,6 +321,8 @@ private:
 	static QString m_profilePath;
 	static QHash<QString, Session::Identity> m_identities;
 	static QVector<Session::MainWindow> m_closedWindows;
+	static QVector<Session::MainWindow> m_savedWindows;
+	static QString m_savedSessionTitle;
 	static bool m_isDirty;
 	static bool m_isPrivate;
 	static bool m_isReadOnly;
@@ -27,8 +27,12 @@
 #include <QtCore/QSettings>
 #include <QtCore/QStandardPaths>
 #include <QtCore/QTextStream>
+#include <QtCore/QThread>
+#include <QtCore/QTimerEvent>
 #include <QtCore/QVector>
 
+#define OVERRIDES_CACHE_LIMIT 1000
+
 namespace Otter
 {
 
@@ -36,13 +40,34 @@ SettingsManager* SettingsManager::m_instance(nullptr);
 QString SettingsManager::m_globalPath;
 QString SettingsManager::m_overridePath;
 QVector<SettingsManager::OptionDefinition> SettingsManager::m_definitions;
+QVector<QVariant> SettingsManager::m_values;
+QHash<QString, QHash<int, QVariant> > SettingsManager::m_overrides;
+QHash<QString, QHash<int, QVariant> > SettingsManager::m_overridesCache;
+QVector<SettingsManager::OverridesNode> SettingsManager::m_overridesTree;
+QVector<SettingsManager::PendingWrite> SettingsManager::m_pendingWrites;
 QHash<QString, int> SettingsManager::m_customOptions;
+QMutex SettingsManager::m_valuesMutex;
 int SettingsManager::m_identifierCounter(-1);
 int SettingsManager::m_optionIdentifierEnumerator(0);
-bool SettingsManager::m_hasWildcardedOverrides(false);
+bool SettingsManager::m_isOverridesTreeOutdated(true);
+bool SettingsManager::m_isSavingImmediately(false);
+
+SettingsManager::SettingsManager(QObject *parent) : QObject(parent),
+	m_saveTimer(0)
+{
+	connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, [&]()
+	{
+		m_isSavingImmediately = true;
+
+		synchronize();
+	});
+}
 
-SettingsManager::SettingsManager(QObject *parent) : QObject(parent)
+SettingsManager::~SettingsManager()
 {
+	m_isSavingImmediately = true;
+
+	synchronize();
 }
 
 void SettingsManager::createInstance(const QString &path)
@@ -98,7 +123,12 @@ void SettingsManager::createInstance(const QString &path)
 	registerOption(Browser_ShowSelectionContextMenuOnDoubleClickOption, BooleanType, false);
 	registerOption(Browser_SpellCheckDictionaryOption, StringType, QString());
 	registerOption(Browser_StartupBehaviorOption, EnumerationType, QLatin1String("continuePrevious"), {QLatin1String("continuePrevious"), QLatin1String("showDialog"), QLatin1String("startHomePage"), QLatin1String("startStartPage"), QLatin1String("startEmpty")});
+	registerOption(Browser_TabsMemoryLimitOption, IntegerType, 0);
+	registerOption(Browser_TransferSegmentsAmountOption, IntegerType, 1);
+	registerOption(Browser_TransferSpeedLimitOption, IntegerType, 0);
 	registerOption(Browser_TransferStartingActionOption, EnumerationType, QLatin1String("doNothing"), {QLatin1String("openTab"), QLatin1String("openBackgroundTab"), QLatin1String("openPanel"), QLatin1String("doNothing")});
+	registerOption(Browser_TransfersLimitOption, IntegerType, 0);
+	registerOption(Browser_TransfersPerHostLimitOption, IntegerType, 0);
 	registerOption(Browser_ValidatorsOrderOption, ListType, QStringList({QLatin1String("w3c-markup"), QLatin1String("w3c-css")}));
 	registerOption(Cache_DiskCacheLimitOption, IntegerType, 51200);
 	registerOption(Cache_PagesInMemoryLimitOption, IntegerType, 5);
@@ -127,6 +157,7 @@ void SettingsManager::createInstance(const QString &path)
 	registerOption(Content_VisitedLinkColorOption, ColorType, QColor(0x55, 0x1A, 0x8B));
 	registerOption(Content_ZoomTextOnlyOption, BooleanType, false);
 	registerOption(ContentBlocking_EnableContentBlockingOption, BooleanType, true);
+	registerOption(ContentBlocking_EnableMergedEvaluationOption, BooleanType, true);
 	registerOption(ContentBlocking_IgnoreHostsOption, ListType, QStringList());
 	registerOption(ContentBlocking_ProfilesOption, ListType, QStringList());
 	registerOption(History_BrowsingLimitAmountGlobalOption, IntegerType, 1000);
@@ -211,6 +242,7 @@ void SettingsManager::createInstance(const QString &path)
 	registerOption(Sessions_OpenInExistingWindowOption, BooleanType, false);
 	registerOption(Sessions_OptionsExludedFromInheritingOption, ListType, QStringList(QLatin1String("Content/PageReloadTime")));
 	registerOption(Sessions_OptionsExludedFromSavingOption, ListType, QStringList());
+	registerOption(Sessions_PrewarmTabsAmountOption, IntegerType, 2);
 	registerOption(SourceViewer_ShowLineNumbersOption, BooleanType, true);
 	registerOption(SourceViewer_WrapLinesOption, BooleanType, false);
 	registerOption(StartPage_BackgroundColorOption, ColorType, QColor());
@@ -246,28 +278,185 @@ void SettingsManager::createInstance(const QString &path)
 	registerOption(Updates_LastCheckOption, StringType, QString());
 	registerOption(Updates_ServerUrlOption, StringType, QLatin1String("https://www.otter-browser.org/updates/update.json"));
 
-	const QStringList hosts(getOverrideHosts());
+	loadOptions();
+}
 
-	for (int i = 0; i < hosts.count(); ++i)
+void SettingsManager::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_saveTimer)
 	{
-		if (hosts.at(i).startsWith(QLatin1Char('*')))
+		synchronize();
+	}
+}
+
+void SettingsManager::scheduleSave()
+{
+	if (m_saveTimer == 0)
+	{
+		m_saveTimer = startTimer(1000);
+	}
+}
+
+void SettingsManager::synchronize()
+{
+	if (m_instance && m_instance->m_saveTimer != 0)
+	{
+		m_instance->killTimer(m_instance->m_saveTimer);
+
+		m_instance->m_saveTimer = 0;
+	}
+
+	m_valuesMutex.lock();
+
+	const QVector<PendingWrite> pendingWrites(m_pendingWrites);
+
+	m_pendingWrites.clear();
+
+	m_valuesMutex.unlock();
+
+	if (!pendingWrites.isEmpty())
+	{
+		writeOptions(pendingWrites);
+	}
+}
+
+void SettingsManager::writeOptions(const QVector<PendingWrite> &writes)
+{
+	QSettings globalSettings(m_globalPath, QSettings::IniFormat);
+	QSettings overrideSettings(m_overridePath, QSettings::IniFormat);
+
+	for (int i = 0; i < writes.count(); ++i)
+	{
+		const PendingWrite &write(writes.at(i));
+		QSettings &settings((write.path == m_overridePath) ? overrideSettings : globalSettings);
+
+		if (write.value.isNull())
 		{
-			m_hasWildcardedOverrides = true;
+			settings.remove(write.key);
+		}
+		else
+		{
+			settings.setValue(write.key, write.value);
+		}
+	}
+}
 
-			break;
+void SettingsManager::reload()
+{
+	synchronize();
+	loadOptions();
+}
+
+void SettingsManager::loadOptions(int identifier)
+{
+	const QSettings globalSettings(m_globalPath, QSettings::IniFormat);
+	const QSettings overrideSettings(m_overridePath, QSettings::IniFormat);
+	const QStringList hosts(overrideSettings.childGroups());
+	const QMutexLocker locker(&m_valuesMutex);
+
+	if (identifier < 0)
+	{
+		m_values = QVector<QVariant>(m_definitions.count());
+		m_overrides.clear();
+	}
+	else
+	{
+		m_values.resize(m_definitions.count());
+	}
+
+	const int from((identifier < 0) ? 0 : identifier);
+	const int to((identifier < 0) ? m_definitions.count() : (identifier + 1));
+
+	for (int i = from; i < to; ++i)
+	{
+		const QString name(getOptionName(i));
+
+		if (globalSettings.contains(name))
+		{
+			m_values[i] = globalSettings.value(name);
+		}
+
+		for (int j = 0; j < hosts.count(); ++j)
+		{
+			const QString overrideName(hosts.at(j) + QLatin1Char('/') + name);
+
+			if (overrideSettings.contains(overrideName))
+			{
+				m_overrides[hosts.at(j)][i] = overrideSettings.value(overrideName);
+			}
 		}
 	}
+
+	m_isOverridesTreeOutdated = true;
 }
 
 void SettingsManager::removeOverride(const QString &host, int identifier)
 {
+	const QMutexLocker locker(&m_valuesMutex);
+
+	m_isOverridesTreeOutdated = true;
+
 	if (identifier < 0)
 	{
-		QSettings(m_overridePath, QSettings::IniFormat).remove(host);
+		m_overrides.remove(host);
+
+		saveOption(m_overridePath, host, {});
+
+		return;
 	}
-	else
+
+	const QHash<QString, QHash<int, QVariant> >::iterator iterator(m_overrides.find(host));
+
+	if (iterator != m_overrides.end())
 	{
-		QSettings(m_overridePath, QSettings::IniFormat).remove(host + QLatin1Char('/') + getOptionName(identifier));
+		iterator.value().remove(identifier);
+
+		if (iterator.value().isEmpty())
+		{
+			m_overrides.erase(iterator);
+		}
+	}
+
+	saveOption(m_overridePath, host + QLatin1Char('/') + getOptionName(identifier), {});
+}
+
+void SettingsManager::updateOverridesTree()
+{
+	m_overridesTree = QVector<OverridesNode>(1);
+	m_overridesCache.clear();
+	m_isOverridesTreeOutdated = false;
+
+	QHash<QString, QHash<int, QVariant> >::const_iterator iterator;
+
+	for (iterator = m_overrides.constBegin(); iterator != m_overrides.constEnd(); ++iterator)
+	{
+		const bool isWildcarded(iterator.key().startsWith(QLatin1String("*.")));
+		const QStringList labels((isWildcarded ? iterator.key().mid(2) : iterator.key()).split(QLatin1Char('.')));
+		int node(0);
+
+		for (int i = (labels.count() - 1); i >= 0; --i)
+		{
+			int child(m_overridesTree.at(node).children.value(labels.at(i), -1));
+
+			if (child < 0)
+			{
+				child = m_overridesTree.count();
+
+				m_overridesTree.append({});
+				m_overridesTree[node].children[labels.at(i)] = child;
+			}
+
+			node = child;
+		}
+
+		if (isWildcarded)
+		{
+			m_overridesTree[node].wildcardedOverrides = iterator.value();
+		}
+		else
+		{
+			m_overridesTree[node].overrides = iterator.value();
+		}
 	}
 }
 
@@ -283,21 +472,29 @@ void SettingsManager::registerOption(int identifier, OptionType type, const QVar
 	m_definitions.append(definition);
 }
 
-void SettingsManager::saveOption(const QString &path, const QString &key, const QVariant &value, OptionType type)
+void SettingsManager::saveOption(const QString &path, const QString &key, const QVariant &value)
 {
-	if (value.isNull())
+	if (m_isSavingImmediately)
 	{
-		QSettings(path, QSettings::IniFormat).remove(key);
+		writeOptions({{path, key, value}});
+
+		return;
 	}
-	else if (type == ColorType)
+
+	m_pendingWrites.append({path, key, value});
+
+	if (!m_instance)
 	{
-		const QColor color(value.value<QColor>());
+		return;
+	}
 
-		QSettings(path, QSettings::IniFormat).setValue(key, (color.isValid() ? color.name(QColor::HexArgb).toUpper() : QString()));
+	if (QThread::currentThread() == m_instance->thread())
+	{
+		m_instance->scheduleSave();
 	}
 	else
 	{
-		QSettings(path, QSettings::IniFormat).setValue(key, value);
+		QMetaObject::invokeMethod(m_instance, "scheduleSave", Qt::QueuedConnection);
 	}
 }
 
@@ -312,25 +509,35 @@ void SettingsManager::updateOptionDefinition(int identifier, const SettingsManag
 
 void SettingsManager::setOption(int identifier, const QVariant &value, const QString &host)
 {
+	if (identifier < 0 || identifier >= m_definitions.count())
+	{
+		return;
+	}
+
 	const QString name(getOptionName(identifier));
-	const OptionType type(getOptionDefinition(identifier).type);
+	QVariant storedValue(value);
 
-	if (!host.isEmpty())
+	if (!value.isNull() && m_definitions.at(identifier).type == ColorType)
 	{
-		const QString overrideName(host + QLatin1Char('/') + name);
+		const QColor color(value.value<QColor>());
+
+		storedValue = (color.isValid() ? color.name(QColor::HexArgb).toUpper() : QString(QLatin1String("")));
+	}
 
+	if (!host.isEmpty())
+	{
 		if (value.isNull())
 		{
-			QSettings(m_overridePath, QSettings::IniFormat).remove(overrideName);
+			removeOverride(host, identifier);
 		}
 		else
 		{
-			saveOption(m_overridePath, overrideName, value, type);
-		}
+			const QMutexLocker locker(&m_valuesMutex);
 
-		if (!m_hasWildcardedOverrides && overrideName.startsWith(QLatin1Char('*')))
-		{
-			m_hasWildcardedOverrides = true;
+			m_overrides[host][identifier] = storedValue;
+			m_isOverridesTreeOutdated = true;
+
+			saveOption(m_overridePath, host + QLatin1Char('/') + name, storedValue);
 		}
 
 		emit m_instance->hostOptionChanged(identifier, value, host);
@@ -340,7 +547,13 @@ void SettingsManager::setOption(int identifier, const QVariant &value, const QSt
 
 	if (getOption(identifier) != value)
 	{
-		saveOption(m_globalPath, name, value, type);
+		m_valuesMutex.lock();
+
+		m_values[identifier] = storedValue;
+
+		saveOption(m_globalPath, name, storedValue);
+
+		m_valuesMutex.unlock();
 
 		emit m_instance->optionChanged(identifier, value);
 	}
@@ -405,28 +618,21 @@ QString SettingsManager::createReport()
 	stream << QLatin1String("Settings:\n");
 
 	QHash<QString, int> overridenValues;
-	QSettings overrides(m_overridePath, QSettings::IniFormat);
-	const QStringList overridesGroups(overrides.childGroups());
 
-	for (int i = 0; i < overridesGroups.count(); ++i)
-	{
-		overrides.beginGroup(overridesGroups.at(i));
+	m_valuesMutex.lock();
+
+	const QVector<QHash<int, QVariant> > overrides(m_overrides.values().toVector());
+
+	m_valuesMutex.unlock();
 
-		const QStringList keys(overrides.allKeys());
+	for (int i = 0; i < overrides.count(); ++i)
+	{
+		QHash<int, QVariant>::const_iterator iterator;
 
-		for (int j = 0; j < keys.count(); ++j)
+		for (iterator = overrides.at(i).constBegin(); iterator != overrides.at(i).constEnd(); ++iterator)
 		{
-			if (overridenValues.contains(keys.at(j)))
-			{
-				++overridenValues[keys.at(j)];
-			}
-			else
-			{
-				overridenValues[keys.at(j)] = 1;
-			}
+			++overridenValues[getOptionName(iterator.key())];
 		}
-
-		overrides.endGroup();
 	}
 
 	const QStringList options(getOptions());
@@ -491,32 +697,21 @@ QVariant SettingsManager::getOption(int identifier, const QString &host)
 		return {};
 	}
 
-	const QString name(getOptionName(identifier));
-
-	if (host.isEmpty())
-	{
-		return QSettings(m_globalPath, QSettings::IniFormat).value(name, m_definitions.at(identifier).defaultValue);
-	}
-
-	const QString overrideName(host + QLatin1Char('/') + name);
-	const QSettings overrides(m_overridePath, QSettings::IniFormat);
+	const QMutexLocker locker(&m_valuesMutex);
 
-	if (m_hasWildcardedOverrides && !overrides.contains(overrideName))
+	if (!host.isEmpty() && !m_overrides.isEmpty())
 	{
-		const QStringList hostParts(host.split(QLatin1Char('.')));
+		const QVariant overrideValue(getOverride(host, identifier));
 
-		for (int i = 1; i < hostParts.count(); ++i)
+		if (!overrideValue.isNull())
 		{
-			const QString wildcardedName(QLatin1String("*.") + QStringList(hostParts.mid(i)).join(QLatin1Char('.')) + QLatin1Char('/') + name);
-
-			if (overrides.contains(wildcardedName))
-			{
-				return QSettings(m_overridePath, QSettings::IniFormat).value(wildcardedName, getOption(identifier));
-			}
+			return overrideValue;
 		}
 	}
 
-	return QSettings(m_overridePath, QSettings::IniFormat).value(overrideName, getOption(identifier));
+	const QVariant value(m_values.value(identifier));
+
+	return (value.isNull() ? m_definitions.at(identifier).defaultValue : value);
 }
 
 QStringList SettingsManager::getOptions()
@@ -536,24 +731,20 @@ QStringList SettingsManager::getOptions()
 
 QStringList SettingsManager::getOverrideHosts(int identifier)
 {
-	if (identifier < 0)
-	{
-		return QSettings(m_overridePath, QSettings::IniFormat).childGroups();
-	}
-
-	const QSettings overrides(m_overridePath, QSettings::IniFormat);
-	const QStringList overridesGroups(overrides.childGroups());
+	const QMutexLocker locker(&m_valuesMutex);
 	QStringList hosts;
-	const QString optionName(getOptionName(identifier));
+	QHash<QString, QHash<int, QVariant> >::const_iterator iterator;
 
-	for (int i = 0; i < overridesGroups.count(); ++i)
+	for (iterator = m_overrides.constBegin(); iterator != m_overrides.constEnd(); ++iterator)
 	{
-		if (overrides.contains(overridesGroups.at(i) + QLatin1Char('/') + optionName))
+		if (identifier < 0 || iterator.value().contains(identifier))
 		{
-			hosts.append(overridesGroups.at(i));
+			hosts.append(iterator.key());
 		}
 	}
 
+	hosts.sort();
+
 	return hosts;
 }
 
@@ -589,6 +780,8 @@ int SettingsManager::registerOption(const QString &name, OptionType type, const
 
 	m_definitions.append(definition);
 
+	loadOptions(identifier);
+
 	return identifier;
 }
 
@@ -610,14 +803,69 @@ int SettingsManager::getOptionIdentifier(const QString &name)
 	return staticMetaObject.enumerator(m_optionIdentifierEnumerator).keyToValue(mutableName.toLatin1());
 }
 
+QVariant SettingsManager::getOverride(const QString &host, int identifier)
+{
+	if (m_isOverridesTreeOutdated)
+	{
+		updateOverridesTree();
+	}
+	else if (m_overridesCache.count() > OVERRIDES_CACHE_LIMIT && !m_overridesCache.contains(host))
+	{
+		m_overridesCache.clear();
+	}
+
+	QHash<int, QVariant> &cachedOverrides(m_overridesCache[host]);
+	const QHash<int, QVariant>::const_iterator cachedOverridesIterator(cachedOverrides.constFind(identifier));
+
+	if (cachedOverridesIterator != cachedOverrides.constEnd())
+	{
+		return cachedOverridesIterator.value();
+	}
+
+	const QStringList labels(host.split(QLatin1Char('.')));
+	QVariant value;
+	int node(0);
+
+	for (int i = (labels.count() - 1); i >= 0; --i)
+	{
+		node = m_overridesTree.at(node).children.value(labels.at(i), -1);
+
+		if (node < 0)
+		{
+			break;
+		}
+
+		const OverridesNode &overridesNode(m_overridesTree.at(node));
+
+		if (i > 0)
+		{
+			if (overridesNode.wildcardedOverrides.contains(identifier))
+			{
+				value = overridesNode.wildcardedOverrides.value(identifier);
+			}
+		}
+		else if (overridesNode.overrides.contains(identifier))
+		{
+			value = overridesNode.overrides.value(identifier);
+		}
+	}
+
+	cachedOverrides[identifier] = value;
+
+	return value;
+}
+
 bool SettingsManager::hasOverride(const QString &host, int identifier)
 {
-	if (identifier < 0)
+	const QMutexLocker locker(&m_valuesMutex);
+	const QHash<QString, QHash<int, QVariant> >::const_iterator iterator(m_overrides.constFind(host));
+
+	if (iterator == m_overrides.constEnd())
 	{
-		return QSettings(m_overridePath, QSettings::IniFormat).childGroups().contains(host);
+		return false;
 	}
 
-	return QSettings(m_overridePath, QSettings::IniFormat).contains(host + QLatin1Char('/') + getOptionName(identifier));
+	return (identifier < 0 || iterator.value().contains(identifier));
 }
 
 }
@@ -22,6 +22,7 @@
 #ifndef OTTER_SETTINGSMANAGER_H
 #define OTTER_SETTINGSMANAGER_H
 
+#include <QtCore/QMutex>
 #include <QtCore/QObject>
 #include <QtCore/QVariant>
 #include <QtGui/QIcon>
@@ -74,7 +75,12 @@ public:
 		Browser_ShowSelectionContextMenuOnDoubleClickOption,
 		Browser_SpellCheckDictionaryOption,
 		Browser_StartupBehaviorOption,
+		Browser_TabsMemoryLimitOption,
+		Browser_TransferSegmentsAmountOption,
+		Browser_TransferSpeedLimitOption,
 		Browser_TransferStartingActionOption,
+		Browser_TransfersLimitOption,
+		Browser_TransfersPerHostLimitOption,
 		Browser_ValidatorsOrderOption,
 		Cache_DiskCacheLimitOption,
 		Cache_PagesInMemoryLimitOption,
@@ -103,6 +109,7 @@ public:
 		Content_VisitedLinkColorOption,
 		Content_ZoomTextOnlyOption,
 		ContentBlocking_EnableContentBlockingOption,
+		ContentBlocking_EnableMergedEvaluationOption,
 		ContentBlocking_IgnoreHostsOption,
 		ContentBlocking_ProfilesOption,
 		History_BrowsingLimitAmountGlobalOption,
@@ -187,6 +194,7 @@ public:
 		Sessions_OpenInExistingWindowOption,
 		Sessions_OptionsExludedFromInheritingOption,
 		Sessions_OptionsExludedFromSavingOption,
+		Sessions_PrewarmTabsAmountOption,
 		SourceViewer_ShowLineNumbersOption,
 		SourceViewer_WrapLinesOption,
 		StartPage_BackgroundColorOption,
@@ -302,10 +310,14 @@ public:
 		}
 	};
 
+	~SettingsManager();
+
 	static void createInstance(const QString &path);
 	static void removeOverride(const QString &host, int identifier = -1);
 	static void updateOptionDefinition(int identifier, const OptionDefinition &definition);
 	static void setOption(int identifier, const QVariant &value, const QString &host = {});
+	static void synchronize();
+	static void reload();
 	static SettingsManager* getInstance();
 	static QString createDisplayValue(int identifier, const QVariant &value);
 	static QString createReport();
@@ -321,20 +333,51 @@ public:
 	static bool hasOverride(const QString &host, int identifier = -1);
 
 protected:
+	struct OverridesNode final
+	{
+		QHash<QString, int> children;
+		QHash<int, QVariant> overrides;
+		QHash<int, QVariant> wildcardedOverrides;
+	};
+
+	struct PendingWrite final
+	{
+		QString path;
+		QString key;
+		QVariant value;
+	};
+
 	explicit SettingsManager(QObject *parent);
 
+	void timerEvent(QTimerEvent *event) override;
+	static void loadOptions(int identifier = -1);
 	static void registerOption(int identifier, OptionType type, const QVariant &defaultValue = {}, const QStringList &choices = {}, OptionDefinition::OptionFlags flags = static_cast<OptionDefinition::OptionFlags>(OptionDefinition::IsEnabledFlag | OptionDefinition::IsVisibleFlag | OptionDefinition::IsBuiltInFlag));
-	static void saveOption(const QString &path, const QString &key, const QVariant &value, OptionType type);
+	static void saveOption(const QString &path, const QString &key, const QVariant &value);
+	static void writeOptions(const QVector<PendingWrite> &writes);
+	static void updateOverridesTree();
+	static QVariant getOverride(const QString &host, int identifier);
+
+protected slots:
+	void scheduleSave();
 
 private:
+	int m_saveTimer;
+
 	static SettingsManager *m_instance;
 	static QString m_globalPath;
 	static QString m_overridePath;
 	static QVector<OptionDefinition> m_definitions;
+	static QVector<QVariant> m_values;
+	static QHash<QString, QHash<int, QVariant> > m_overrides;
+	static QHash<QString, QHash<int, QVariant> > m_overridesCache;
+	static QVector<OverridesNode> m_overridesTree;
+	static QVector<PendingWrite> m_pendingWrites;
 	static QHash<QString, int> m_customOptions;
+	static QMutex m_valuesMutex;
 	static int m_identifierCounter;
 	static int m_optionIdentifierEnumerator;
-	static bool m_hasWildcardedOverrides;
+	static bool m_isOverridesTreeOutdated;
+	static bool m_isSavingImmediately;
 
 signals:
 	void optionChanged(int identifier, const QVariant &value);
@@ -0,0 +1,260 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "TabSuspensionManager.h"
+#include "Application.h"
+#include "SettingsManager.h"
+#include "../ui/MainWindow.h"
+#include "../ui/WebWidget.h"
+#include "../ui/Window.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QFile>
+#include <QtCore/QMultiMap>
+
+#define PREWARM_INTERVAL 2000
+#define SUSPENSION_BATCH_SIZE 5
+#define SUSPENSION_CHECK_INTERVAL 10000
+
+namespace Otter
+{
+
+TabSuspensionManager* TabSuspensionManager::m_instance(nullptr);
+QQueue<QPointer<Window> > TabSuspensionManager::m_prewarmQueue;
+QHash<quint64, QDateTime> TabSuspensionManager::m_activityTimes;
+
+TabSuspensionManager::TabSuspensionManager(QObject *parent) : QObject(parent),
+	m_suspensionTimer(0),
+	m_prewarmTimer(0)
+{
+	handleOptionChanged(SettingsManager::Browser_InactiveTabTimeUntilSuspendOption);
+
+	connect(SettingsManager::getInstance(), &SettingsManager::optionChanged, this, &TabSuspensionManager::handleOptionChanged);
+}
+
+void TabSuspensionManager::createInstance()
+{
+	if (!m_instance)
+	{
+		m_instance = new TabSuspensionManager(QCoreApplication::instance());
+	}
+}
+
+void TabSuspensionManager::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_suspensionTimer)
+	{
+		suspendWindows();
+	}
+	else if (event->timerId() == m_prewarmTimer)
+	{
+		const int memoryLimit(SettingsManager::getOption(SettingsManager::Browser_TabsMemoryLimitOption).toInt());
+
+		if (memoryLimit > 0 && getMemoryUsage() > (static_cast<qint64>(memoryLimit) * 1048576))
+		{
+			m_prewarmQueue.clear();
+		}
+
+		while (!m_prewarmQueue.isEmpty())
+		{
+			Window *window(m_prewarmQueue.dequeue());
+
+			if (window && window->isSuspended())
+			{
+				restoreWindow(window);
+
+				break;
+			}
+		}
+
+		if (m_prewarmQueue.isEmpty())
+		{
+			killTimer(m_prewarmTimer);
+
+			m_prewarmTimer = 0;
+		}
+	}
+}
+
+void TabSuspensionManager::suspendWindows()
+{
+	const QDateTime currentDateTime(QDateTime::currentDateTimeUtc());
+	const QVector<MainWindow*> mainWindows(Application::getWindows());
+	const int suspendTime(SettingsManager::getOption(SettingsManager::Browser_InactiveTabTimeUntilSuspendOption).toInt());
+	const int memoryLimit(SettingsManager::getOption(SettingsManager::Browser_TabsMemoryLimitOption).toInt());
+	QHash<quint64, QDateTime> activityTimes;
+	QMultiMap<QDateTime, Window*> candidates;
+
+	for (int i = 0; i < mainWindows.count(); ++i)
+	{
+		for (int j = 0; j < mainWindows.at(i)->getWindowCount(); ++j)
+		{
+			Window *window(mainWindows.at(i)->getWindowByIndex(j));
+
+			if (!window)
+			{
+				continue;
+			}
+
+			const quint64 identifier(window->getIdentifier());
+			QDateTime lastActivity(window->getLastActivity());
+
+			if (m_activityTimes.contains(identifier) && (!lastActivity.isValid() || m_activityTimes[identifier] > lastActivity))
+			{
+				lastActivity = m_activityTimes[identifier];
+			}
+
+			if (!lastActivity.isValid())
+			{
+				lastActivity = currentDateTime;
+			}
+
+			activityTimes[identifier] = lastActivity;
+
+			if (!canSuspend(window))
+			{
+				continue;
+			}
+
+			if (suspendTime >= 0 && lastActivity.secsTo(currentDateTime) >= suspendTime)
+			{
+				window->triggerAction(ActionsManager::SuspendTabAction);
+			}
+			else
+			{
+				candidates.insert(lastActivity, window);
+			}
+		}
+	}
+
+	m_activityTimes = activityTimes;
+
+	if (memoryLimit <= 0 || candidates.isEmpty() || getMemoryUsage() <= (static_cast<qint64>(memoryLimit) * 1048576))
+	{
+		return;
+	}
+
+	QMultiMap<QDateTime, Window*>::const_iterator iterator;
+	int amount(0);
+
+	for (iterator = candidates.constBegin(); (iterator != candidates.constEnd() && amount < SUSPENSION_BATCH_SIZE); ++iterator)
+	{
+		iterator.value()->triggerAction(ActionsManager::SuspendTabAction);
+
+		++amount;
+	}
+}
+
+void TabSuspensionManager::restoreWindow(Window *window)
+{
+	if (!window || !window->isSuspended())
+	{
+		return;
+	}
+
+	m_activityTimes[window->getIdentifier()] = QDateTime::currentDateTimeUtc();
+
+	window->getContentsWidget();
+}
+
+void TabSuspensionManager::prewarmWindows(const QVector<Window*> &windows)
+{
+	if (!m_instance)
+	{
+		return;
+	}
+
+	for (int i = 0; i < windows.count(); ++i)
+	{
+		m_prewarmQueue.enqueue(windows.at(i));
+	}
+
+	if (m_instance->m_prewarmTimer == 0 && !m_prewarmQueue.isEmpty())
+	{
+		m_instance->m_prewarmTimer = m_instance->startTimer(PREWARM_INTERVAL);
+	}
+}
+
+void TabSuspensionManager::handleOptionChanged(int identifier)
+{
+	if (identifier != SettingsManager::Browser_InactiveTabTimeUntilSuspendOption && identifier != SettingsManager::Browser_TabsMemoryLimitOption)
+	{
+		return;
+	}
+
+	const bool isEnabled(SettingsManager::getOption(SettingsManager::Browser_InactiveTabTimeUntilSuspendOption).toInt() >= 0 || SettingsManager::getOption(SettingsManager::Browser_TabsMemoryLimitOption).toInt() > 0);
+
+	if (isEnabled && m_suspensionTimer == 0)
+	{
+		m_suspensionTimer = startTimer(SUSPENSION_CHECK_INTERVAL);
+	}
+	else if (!isEnabled && m_suspensionTimer != 0)
+	{
+		killTimer(m_suspensionTimer);
+
+		m_suspensionTimer = 0;
+
+		m_activityTimes.clear();
+	}
+}
+
+TabSuspensionManager* TabSuspensionManager::getInstance()
+{
+	return m_instance;
+}
+
+qint64 TabSuspensionManager::getMemoryUsage()
+{
+	QFile file(QLatin1String("/proc/self/status"));
+
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+	{
+		return -1;
+	}
+
+	while (!file.atEnd())
+	{
+		const QByteArray line(file.readLine());
+
+		if (line.startsWith("VmRSS:"))
+		{
+			const QList<QByteArray> fields(line.mid(6).simplified().split(' '));
+			bool isValid(false);
+			const qint64 usage(fields.value(0).toLongLong(&isValid));
+
+			return (isValid ? (usage * 1024) : -1);
+		}
+	}
+
+	return -1;
+}
+
+bool TabSuspensionManager::canSuspend(Window *window)
+{
+	if (window->isSuspended() || window->isVisible() || window->isAboutToClose() || window->getType() != QLatin1String("web") || window->getLoadingState() == WebWidget::OngoingLoadingState)
+	{
+		return false;
+	}
+
+	const WebWidget *webWidget(window->getWebWidget());
+
+	return (webWidget && !webWidget->isAudible() && !webWidget->isModified());
+}
+
+}
@@ -0,0 +1,66 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_TABSUSPENSIONMANAGER_H
+#define OTTER_TABSUSPENSIONMANAGER_H
+
+#include <QtCore/QDateTime>
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QQueue>
+
+namespace Otter
+{
+
+class Window;
+
+class TabSuspensionManager final : public QObject
+{
+	Q_OBJECT
+
+public:
+	static void createInstance();
+	static void restoreWindow(Window *window);
+	static void prewarmWindows(const QVector<Window*> &windows);
+	static TabSuspensionManager* getInstance();
+	static qint64 getMemoryUsage();
+
+protected:
+	explicit TabSuspensionManager(QObject *parent = nullptr);
+
+	void timerEvent(QTimerEvent *event) override;
+	void suspendWindows();
+	static bool canSuspend(Window *window);
+
+protected slots:
+	void handleOptionChanged(int identifier);
+
+private:
+	int m_suspensionTimer;
+	int m_prewarmTimer;
+
+	static TabSuspensionManager *m_instance;
+	static QQueue<QPointer<Window> > m_prewarmQueue;
+	static QHash<quint64, QDateTime> m_activityTimes;
+};
+
+}
+
+#endif
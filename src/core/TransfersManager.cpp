@@ -27,70 +27,119 @@
 #include "Utils.h"
 #include "../ui/MainWindow.h"
 
+#include <QtConcurrent/QtConcurrentRun>
 #include <QtCore/QDir>
 #include <QtCore/QMimeDatabase>
 #include <QtCore/QRegularExpression>
 #include <QtCore/QStandardPaths>
 #include <QtCore/QTemporaryFile>
+#include <QtCore/QThreadPool>
 #include <QtCore/QTimer>
 #include <QtNetwork/QAbstractNetworkCache>
 #include <QtWidgets/QFileIconProvider>
 #include <QtWidgets/QMessageBox>
 
+#define TRANSFERS_SCHEDULER_INTERVAL 100
+#define TRANSFER_HASH_CHUNK_SIZE 1048576
+#define TRANSFER_READ_BUFFER_SIZE 4194304
+#define TRANSFER_SEGMENT_MINIMUM_SIZE 1048576
+#define TRANSFER_SEGMENTS_LIMIT 16
+#define TRANSFER_WRITE_BLOCK_SIZE 1048576
+#define TRANSFER_WRITE_QUEUE_LIMIT 4
+
 namespace Otter
 {
 
 TransfersManager* TransfersManager::m_instance(nullptr);
 QVector<Transfer*> TransfersManager::m_transfers;
 QVector<Transfer*> TransfersManager::m_privateTransfers;
+qint64 TransfersManager::m_bandwidthTokens(0);
 bool TransfersManager::m_isInitilized(false);
 bool TransfersManager::m_hasRunningTransfers(false);
 
+QThreadPool* Transfer::m_writerThreadPool(nullptr);
+
 Transfer::Transfer(TransferOptions options, QObject *parent) : QObject(parent ? parent : TransfersManager::getInstance()),
 	m_reply(nullptr),
 	m_device(nullptr),
+	m_writesWatcher(nullptr),
+	m_hashesWatcher(nullptr),
 	m_speed(0),
 	m_bytesStart(0),
 	m_bytesReceivedDifference(0),
 	m_bytesReceived(0),
 	m_bytesTotal(0),
+	m_hashedBytes(0),
+	m_writeOffset(0),
+	m_speedLimit(0),
+	m_bandwidthTokens(0),
 	m_options(options),
 	m_state(UnknownState),
+	m_priority(NormalPriority),
 	m_updateTimer(0),
 	m_updateInterval(0),
 	m_remainingTime(-1),
 	m_isSelectingPath(false),
-	m_isArchived(false)
+	m_isArchived(false),
+	m_hasWriteError(false),
+	m_isQueued(false)
 {
 }
 
 Transfer::Transfer(const QSettings &settings, QObject *parent) : QObject(parent ? parent : TransfersManager::getInstance()),
 	m_reply(nullptr),
 	m_device(nullptr),
+	m_writesWatcher(nullptr),
+	m_hashesWatcher(nullptr),
 	m_source(settings.value(QLatin1String("source")).toUrl()),
 	m_target(settings.value(QLatin1String("target")).toString()),
 	m_timeStarted(settings.value(QLatin1String("timeStarted")).toDateTime()),
 	m_timeFinished(settings.value(QLatin1String("timeFinished")).toDateTime()),
 	m_mimeType(QMimeDatabase().mimeTypeForFile(m_target)),
+	m_validator(settings.value(QLatin1String("validator")).toString().toLatin1()),
 	m_speed(0),
 	m_bytesStart(0),
 	m_bytesReceivedDifference(0),
 	m_bytesReceived(settings.value(QLatin1String("bytesReceived")).toLongLong()),
 	m_bytesTotal(settings.value(QLatin1String("bytesTotal")).toLongLong()),
+	m_hashedBytes(0),
+	m_writeOffset(0),
+	m_speedLimit(settings.value(QLatin1String("speedLimit")).toLongLong()),
+	m_bandwidthTokens(m_speedLimit),
 	m_options(NoOption),
 	m_state((m_bytesReceived > 0 && m_bytesTotal == m_bytesReceived && QFile::exists(settings.value(QLatin1String("target")).toString())) ? FinishedState : ErrorState),
+	m_priority(static_cast<TransferPriority>(settings.value(QLatin1String("priority"), NormalPriority).toInt())),
 	m_updateTimer(0),
 	m_updateInterval(0),
 	m_remainingTime(-1),
 	m_isSelectingPath(false),
-	m_isArchived(true)
+	m_isArchived(true),
+	m_hasWriteError(false),
+	m_isQueued(m_state == ErrorState && settings.value(QLatin1String("queued")).toBool())
 {
 	m_timeStarted.setTimeSpec(Qt::UTC);
 	m_timeFinished.setTimeSpec(Qt::UTC);
+
+	const QStringList segments(settings.value(QLatin1String("segments")).toStringList());
+
+	for (int i = 0; i < segments.count(); ++i)
+	{
+		TransferSegment segment;
+		segment.offset = segments.at(i).section(QLatin1Char('-'), 0, 0).toLongLong();
+		segment.end = segments.at(i).section(QLatin1Char('-'), 1, 1).toLongLong();
+
+		if (segment.offset < segment.end && segment.end <= m_bytesTotal)
+		{
+			m_segments.append(segment);
+		}
+	}
 }
 
 Transfer::~Transfer()
 {
+	waitForWrites();
+	qDeleteAll(m_hashers);
+
 	if (m_options.testFlag(HasToOpenAfterFinishOption) && QFile::exists(m_target))
 	{
 		QFile::remove(m_target);
@@ -151,6 +200,7 @@ void Transfer::start(QNetworkReply *reply, const QString &target)
 	const QMimeDatabase mimeDatabase;
 
 	m_reply = reply;
+	m_reply->setReadBufferSize(TRANSFER_READ_BUFFER_SIZE);
 	m_source = reply->request().url().adjusted(QUrl::RemovePassword | QUrl::PreferLocalFile);
 	m_mimeType = mimeDatabase.mimeTypeForName(m_reply->header(QNetworkRequest::ContentTypeHeader).toString());
 
@@ -225,6 +275,9 @@ void Transfer::start(QNetworkReply *reply, const QString &target)
 		}
 	}
 
+	writeReplyData(true);
+	waitForWrites();
+
 	m_device->reset();
 
 	m_mimeType = mimeDatabase.mimeTypeForData(m_device);
@@ -322,6 +375,514 @@ void Transfer::start(QNetworkReply *reply, const QString &target)
 	}
 }
 
+void Transfer::startSegments()
+{
+	waitForWrites();
+
+	if (!m_reply || !m_device || m_device->inherits("QTemporaryFile") || m_reply->attribute(QNetworkRequest::SourceIsFromCacheAttribute).toBool() || m_reply->rawHeader(QByteArrayLiteral("Accept-Ranges")).trimmed().toLower() != QByteArrayLiteral("bytes"))
+	{
+		return;
+	}
+
+	m_validator = getValidator(m_reply);
+
+	if (m_validator.isEmpty())
+	{
+		return;
+	}
+
+	const int hostLimit(SettingsManager::getOption(SettingsManager::Browser_TransfersPerHostLimitOption).toInt());
+	int amount(qMin(SettingsManager::getOption(SettingsManager::Browser_TransferSegmentsAmountOption).toInt(), TRANSFER_SEGMENTS_LIMIT));
+
+	if (hostLimit > 0)
+	{
+		amount = qMin(amount, hostLimit);
+	}
+
+	const qint64 offset(m_device->size());
+
+	if (amount < 2 || m_bytesTotal <= 0 || (m_bytesTotal - offset) < (amount * TRANSFER_SEGMENT_MINIMUM_SIZE) || !m_device->resize(m_bytesTotal))
+	{
+		return;
+	}
+
+	m_reply->disconnect(this);
+
+	const qint64 segmentSize((m_bytesTotal - offset) / amount);
+
+	m_segments.clear();
+	m_segments.reserve(amount);
+
+	for (int i = 0; i < amount; ++i)
+	{
+		TransferSegment segment;
+		segment.offset = (offset + (i * segmentSize));
+		segment.end = ((i == (amount - 1)) ? m_bytesTotal : (segment.offset + segmentSize));
+
+		m_segments.append(segment);
+	}
+
+	m_segments[0].reply = m_reply;
+	m_segments[0].timer.start();
+
+	connect(m_reply, &QNetworkReply::readyRead, this, &Transfer::handleSegmentDataAvailable);
+	connect(m_reply, &QNetworkReply::finished, this, &Transfer::handleSegmentFinished);
+
+	for (int i = 1; i < amount; ++i)
+	{
+		startSegment(i);
+	}
+
+	if (m_reply->bytesAvailable() > 0)
+	{
+		handleSegmentDataAvailable();
+	}
+}
+
+void Transfer::startSegment(int index)
+{
+	TransferSegment &segment(m_segments[index]);
+	QNetworkRequest request;
+	request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
+	request.setAttribute(QNetworkRequest::FollowRedirectsAttribute, true);
+	request.setHeader(QNetworkRequest::UserAgentHeader, NetworkManagerFactory::getUserAgent());
+	request.setRawHeader(QByteArrayLiteral("Range"), QStringLiteral("bytes=%1-%2").arg(segment.offset).arg(segment.end - 1).toLatin1());
+	request.setRawHeader(QByteArrayLiteral("If-Range"), m_validator);
+	request.setPriority(QNetworkRequest::LowPriority);
+	request.setUrl(m_source);
+
+	segment.reply = NetworkManagerFactory::getNetworkManager(m_options.testFlag(IsPrivateOption))->get(request);
+	segment.reply->setReadBufferSize(TRANSFER_READ_BUFFER_SIZE);
+	segment.bytesReceived = 0;
+	segment.timer.start();
+
+	connect(segment.reply, &QNetworkReply::readyRead, this, &Transfer::handleSegmentDataAvailable);
+	connect(segment.reply, &QNetworkReply::finished, this, &Transfer::handleSegmentFinished);
+}
+
+void Transfer::restartWithoutSegments()
+{
+	if (m_options.testFlag(CanAutoDeleteOption))
+	{
+		handleDownloadError(QNetworkReply::UnknownContentError);
+
+		return;
+	}
+
+	m_validator.clear();
+
+	restart();
+}
+
+void Transfer::stopSegments()
+{
+	for (int i = 0; i < m_segments.count(); ++i)
+	{
+		QNetworkReply *reply(m_segments.at(i).reply);
+
+		if (reply)
+		{
+			reply->disconnect(this);
+
+			reply->abort();
+
+			QTimer::singleShot(250, reply, &QNetworkReply::deleteLater);
+
+			m_segments[i].reply = nullptr;
+		}
+	}
+}
+
+void Transfer::finishSegment(int index)
+{
+	QNetworkReply *reply(m_segments.at(index).reply);
+
+	if (reply)
+	{
+		reply->disconnect(this);
+
+		if (!reply->isFinished())
+		{
+			reply->abort();
+		}
+
+		QTimer::singleShot(250, reply, &QNetworkReply::deleteLater);
+
+		m_segments[index].reply = nullptr;
+	}
+
+	int slowestIndex(-1);
+	qint64 slowestTime(0);
+	bool isFinished(true);
+
+	for (int i = 0; i < m_segments.count(); ++i)
+	{
+		const TransferSegment &segment(m_segments.at(i));
+		const qint64 remainingBytes(segment.end - segment.offset);
+
+		if (remainingBytes <= 0)
+		{
+			continue;
+		}
+
+		isFinished = false;
+
+		if (segment.reply && remainingBytes >= (2 * TRANSFER_SEGMENT_MINIMUM_SIZE))
+		{
+			const qint64 remainingTime((remainingBytes * qMax(segment.timer.elapsed(), static_cast<qint64>(1))) / qMax(segment.bytesReceived, static_cast<qint64>(1)));
+
+			if (remainingTime > slowestTime)
+			{
+				slowestIndex = i;
+				slowestTime = remainingTime;
+			}
+		}
+	}
+
+	if (isFinished)
+	{
+		finishSegmentedTransfer();
+
+		return;
+	}
+
+	if (slowestIndex >= 0)
+	{
+		TransferSegment &slowestSegment(m_segments[slowestIndex]);
+		TransferSegment &segment(m_segments[index]);
+		segment.offset = (slowestSegment.offset + ((slowestSegment.end - slowestSegment.offset) / 2));
+		segment.end = slowestSegment.end;
+
+		slowestSegment.end = segment.offset;
+
+		startSegment(index);
+	}
+}
+
+void Transfer::finishSegmentedTransfer()
+{
+	waitForWrites();
+
+	if (m_hasWriteError)
+	{
+		handleDownloadError(QNetworkReply::UnknownContentError);
+
+		return;
+	}
+
+	m_segments.clear();
+
+	if (m_updateTimer != 0)
+	{
+		killTimer(m_updateTimer);
+
+		m_updateTimer = 0;
+	}
+
+	markAsFinished();
+	finalizeHashes();
+
+	m_bytesReceived = m_bytesTotal;
+	m_state = FinishedState;
+
+	if (m_device)
+	{
+		m_device->close();
+		m_device->deleteLater();
+		m_device = nullptr;
+	}
+
+	m_mimeType = QMimeDatabase().mimeTypeForFile(m_target);
+
+	emit finished();
+	emit changed();
+
+	if (m_options.testFlag(HasToOpenAfterFinishOption))
+	{
+		openTarget();
+	}
+
+	if (m_options.testFlag(CanAutoDeleteOption) && !m_isSelectingPath)
+	{
+		deleteLater();
+	}
+}
+
+void Transfer::updateSegmentsProgress()
+{
+	qint64 remainingBytes(0);
+
+	for (int i = 0; i < m_segments.count(); ++i)
+	{
+		remainingBytes += (m_segments.at(i).end - m_segments.at(i).offset);
+	}
+
+	m_bytesReceived = (m_bytesTotal - remainingBytes);
+
+	emit progressChanged(m_bytesReceived, m_bytesTotal);
+}
+
+void Transfer::writeReplyData(bool canWritePartialBlock)
+{
+	if (!m_reply || !m_device)
+	{
+		return;
+	}
+
+	removeFinishedWrites();
+
+	while (m_reply->bytesAvailable() > 0 && m_writes.count() < TRANSFER_WRITE_QUEUE_LIMIT)
+	{
+		const qint64 blockSize(TRANSFER_WRITE_BLOCK_SIZE - (m_writeOffset % TRANSFER_WRITE_BLOCK_SIZE));
+		const qint64 readLimit(getReadLimit(m_reply, blockSize));
+
+		if (readLimit <= 0 || (readLimit == blockSize && !canWritePartialBlock && m_reply->bytesAvailable() < blockSize))
+		{
+			break;
+		}
+
+		const QByteArray data(m_reply->read(readLimit));
+
+		if (data.isEmpty())
+		{
+			break;
+		}
+
+		updateHashes(m_writeOffset, data);
+		enqueueWrite(m_writeOffset, data);
+		consumeBandwidth(data.size());
+
+		m_writeOffset += data.size();
+	}
+
+	if (m_reply->bytesAvailable() > 0 && m_writes.count() >= TRANSFER_WRITE_QUEUE_LIMIT)
+	{
+		watchWrites();
+	}
+}
+
+void Transfer::enqueueWrite(qint64 offset, const QByteArray &data)
+{
+	QFile *device(m_device);
+
+	m_writes.enqueue(QtConcurrent::run(getWriterThreadPool(), [=]()
+	{
+		return (device->seek(offset) && device->write(data) == data.size() && device->flush());
+	}));
+}
+
+void Transfer::watchWrites()
+{
+	if (m_writes.isEmpty())
+	{
+		return;
+	}
+
+	if (!m_writesWatcher)
+	{
+		m_writesWatcher = new QFutureWatcher<bool>(this);
+
+		connect(m_writesWatcher, &QFutureWatcher<bool>::finished, this, &Transfer::handleWritesFinished);
+	}
+
+	if (!m_writesWatcher->isRunning())
+	{
+		m_writesWatcher->setFuture(m_writes.head());
+	}
+}
+
+void Transfer::removeFinishedWrites()
+{
+	while (!m_writes.isEmpty() && m_writes.head().isFinished())
+	{
+		if (!m_writes.dequeue().result())
+		{
+			m_hasWriteError = true;
+		}
+	}
+}
+
+void Transfer::waitForWrites()
+{
+	while (!m_writes.isEmpty())
+	{
+		if (!m_writes.dequeue().result())
+		{
+			m_hasWriteError = true;
+		}
+	}
+}
+
+void Transfer::processData()
+{
+	if (m_segments.isEmpty())
+	{
+		handleDataAvailable();
+
+		return;
+	}
+
+	for (int i = 0; i < m_segments.count(); ++i)
+	{
+		processSegment(i);
+	}
+}
+
+void Transfer::consumeBandwidth(qint64 amount)
+{
+	if (m_speedLimit > 0)
+	{
+		m_bandwidthTokens = qMax(static_cast<qint64>(0), (m_bandwidthTokens - amount));
+	}
+
+	TransfersManager::consumeBandwidth(amount);
+}
+
+void Transfer::refillBandwidth(int interval)
+{
+	if (m_speedLimit > 0)
+	{
+		m_bandwidthTokens = qMin(m_speedLimit, (m_bandwidthTokens + ((m_speedLimit * interval) / 1000)));
+	}
+
+	if (m_state == RunningState)
+	{
+		processData();
+	}
+}
+
+void Transfer::updateHashes(qint64 offset, const QByteArray &data)
+{
+	if (m_hashes.isEmpty() || offset != m_hashedBytes)
+	{
+		return;
+	}
+
+	QHash<QCryptographicHash::Algorithm, QByteArray>::const_iterator iterator;
+
+	for (iterator = m_hashes.constBegin(); iterator != m_hashes.constEnd(); ++iterator)
+	{
+		if (!m_hashers.contains(iterator.key()))
+		{
+			if (m_hashedBytes > 0)
+			{
+				return;
+			}
+
+			m_hashers[iterator.key()] = new QCryptographicHash(iterator.key());
+		}
+	}
+
+	QHash<QCryptographicHash::Algorithm, QCryptographicHash*>::iterator hashersIterator;
+
+	for (hashersIterator = m_hashers.begin(); hashersIterator != m_hashers.end(); ++hashersIterator)
+	{
+		hashersIterator.value()->addData(data);
+	}
+
+	m_hashedBytes += data.size();
+}
+
+void Transfer::resetHashes()
+{
+	if (m_hashesWatcher)
+	{
+		m_hashesWatcher->disconnect(this);
+
+		if (m_hashesWatcher->isFinished())
+		{
+			m_hashesWatcher->deleteLater();
+		}
+		else
+		{
+			connect(m_hashesWatcher, &QFutureWatcher<QHash<QCryptographicHash::Algorithm, QByteArray> >::finished, m_hashesWatcher, &QFutureWatcher<QHash<QCryptographicHash::Algorithm, QByteArray> >::deleteLater);
+		}
+
+		m_hashesWatcher = nullptr;
+	}
+
+	qDeleteAll(m_hashers);
+
+	m_hashers.clear();
+	m_hashResults.clear();
+
+	m_hashedBytes = 0;
+}
+
+void Transfer::finalizeHashes()
+{
+	if (m_hashes.isEmpty())
+	{
+		return;
+	}
+
+	if (m_hashers.count() != m_hashes.count())
+	{
+		resetHashes();
+
+		QHash<QCryptographicHash::Algorithm, QByteArray>::const_iterator iterator;
+
+		for (iterator = m_hashes.constBegin(); iterator != m_hashes.constEnd(); ++iterator)
+		{
+			m_hashers[iterator.key()] = new QCryptographicHash(iterator.key());
+		}
+	}
+
+	waitForWrites();
+
+	const QHash<QCryptographicHash::Algorithm, QCryptographicHash*> hashers(m_hashers);
+	const QString target(m_target);
+	const qint64 offset(m_hashedBytes);
+
+	m_hashers.clear();
+
+	m_hashedBytes = 0;
+
+	resetHashes();
+
+	m_hashesWatcher = new QFutureWatcher<QHash<QCryptographicHash::Algorithm, QByteArray> >(this);
+
+	connect(m_hashesWatcher, &QFutureWatcher<QHash<QCryptographicHash::Algorithm, QByteArray> >::finished, this, &Transfer::handleHashesFinalized);
+
+	m_hashesWatcher->setFuture(QtConcurrent::run([=]()
+	{
+		QFile file(target);
+
+		if (file.size() > offset && file.open(QIODevice::ReadOnly) && file.seek(offset))
+		{
+			while (!file.atEnd())
+			{
+				const QByteArray data(file.read(TRANSFER_HASH_CHUNK_SIZE));
+				QHash<QCryptographicHash::Algorithm, QCryptographicHash*>::const_iterator iterator;
+
+				if (data.isEmpty())
+				{
+					break;
+				}
+
+				for (iterator = hashers.constBegin(); iterator != hashers.constEnd(); ++iterator)
+				{
+					iterator.value()->addData(data);
+				}
+			}
+
+			file.close();
+		}
+
+		QHash<QCryptographicHash::Algorithm, QByteArray> results;
+		QHash<QCryptographicHash::Algorithm, QCryptographicHash*>::const_iterator iterator;
+
+		for (iterator = hashers.constBegin(); iterator != hashers.constEnd(); ++iterator)
+		{
+			results[iterator.key()] = iterator.value()->result();
+		}
+
+		qDeleteAll(hashers);
+
+		return results;
+	}));
+}
+
 void Transfer::openTarget() const
 {
 	Utils::runApplication(m_openCommand, QUrl::fromLocalFile(getTarget()));
@@ -340,11 +901,15 @@ void Transfer::cancel()
 
 	if (m_device)
 	{
+		waitForWrites();
+
 		m_device->remove();
 	}
 
 	stop();
 
+	m_segments.clear();
+
 	if (m_options.testFlag(CanAutoDeleteOption) && !m_isSelectingPath)
 	{
 		deleteLater();
@@ -353,6 +918,8 @@ void Transfer::cancel()
 
 void Transfer::stop()
 {
+	m_isQueued = false;
+
 	if (m_updateTimer != 0)
 	{
 		killTimer(m_updateTimer);
@@ -360,6 +927,9 @@ void Transfer::stop()
 		m_updateTimer = 0;
 	}
 
+	stopSegments();
+	waitForWrites();
+
 	if (m_reply)
 	{
 		m_reply->abort();
@@ -422,14 +992,32 @@ void Transfer::handleDataAvailable()
 
 		if (m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).isValid() && m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() != 206)
 		{
+			waitForWrites();
+
 			m_device->reset();
+
+			m_writeOffset = 0;
+			m_validator = getValidator(m_reply);
+
+			resetHashes();
 		}
 	}
 
-	m_device->write(m_reply->readAll());
-	m_device->seek(m_device->size());
+	if (m_validator.isEmpty())
+	{
+		m_validator = getValidator(m_reply);
+	}
+
+	writeReplyData(m_reply->isFinished());
+
+	if (m_hasWriteError)
+	{
+		handleDownloadError(QNetworkReply::UnknownContentError);
+
+		return;
+	}
 
-	if (m_state == RunningState && m_reply->attribute(QNetworkRequest::SourceIsFromCacheAttribute).toBool() && m_bytesTotal >= 0 && m_device->size() == m_bytesTotal)
+	if (m_state == RunningState && m_reply->attribute(QNetworkRequest::SourceIsFromCacheAttribute).toBool() && m_bytesTotal >= 0 && (m_writeOffset + m_reply->bytesAvailable()) == m_bytesTotal)
 	{
 		handleDownloadFinished();
 	}
@@ -439,6 +1027,8 @@ void Transfer::handleDownloadFinished()
 {
 	if (!m_reply)
 	{
+		waitForWrites();
+
 		if (m_device && !m_device->inherits("QTemporaryFile"))
 		{
 			m_device->close();
@@ -479,11 +1069,16 @@ void Transfer::handleDownloadFinished()
 		m_updateTimer = 0;
 	}
 
-	if (m_reply->size() > 0)
+	writeReplyData(true);
+
+	while (m_reply->bytesAvailable() > 0 && !m_writes.isEmpty())
 	{
-		m_device->write(m_reply->readAll());
+		waitForWrites();
+		writeReplyData(true);
 	}
 
+	waitForWrites();
+
 	disconnect(m_reply, &QNetworkReply::downloadProgress, this, &Transfer::handleDownloadProgress);
 	disconnect(m_reply, &QNetworkReply::readyRead, this, &Transfer::handleDataAvailable);
 	disconnect(m_reply, &QNetworkReply::finished, this, &Transfer::handleDownloadFinished);
@@ -495,13 +1090,14 @@ void Transfer::handleDownloadFinished()
 		m_bytesTotal = m_bytesReceived;
 	}
 
-	if (m_bytesReceived == 0 || m_bytesReceived < m_bytesTotal)
+	if (m_hasWriteError || m_bytesReceived == 0 || m_bytesReceived < m_bytesTotal)
 	{
 		m_state = ErrorState;
 	}
 	else
 	{
 		markAsFinished();
+		finalizeHashes();
 
 		m_state = FinishedState;
 		m_mimeType = QMimeDatabase().mimeTypeForFile(m_target);
@@ -547,6 +1143,116 @@ void Transfer::handleDownloadError(QNetworkReply::NetworkError error)
 	}
 }
 
+void Transfer::handleSegmentDataAvailable()
+{
+	processSegment(findSegment(qobject_cast<QNetworkReply*>(sender())));
+}
+
+void Transfer::processSegment(int index)
+{
+	if (index < 0 || !m_device || !m_segments.at(index).reply)
+	{
+		return;
+	}
+
+	if (!isSegmentReplyValid(index))
+	{
+		restartWithoutSegments();
+
+		return;
+	}
+
+	if (!writeSegmentData(index, m_segments.at(index).reply->isFinished()))
+	{
+		handleDownloadError(QNetworkReply::UnknownContentError);
+
+		return;
+	}
+
+	updateSegmentsProgress();
+
+	if (m_segments.at(index).offset >= m_segments.at(index).end)
+	{
+		finishSegment(index);
+	}
+}
+
+void Transfer::handleSegmentFinished()
+{
+	QNetworkReply *reply(qobject_cast<QNetworkReply*>(sender()));
+	const int index(findSegment(reply));
+
+	if (index < 0 || !m_device)
+	{
+		return;
+	}
+
+	if (reply->error() != QNetworkReply::NoError)
+	{
+		handleDownloadError(reply->error());
+
+		return;
+	}
+
+	if (!isSegmentReplyValid(index))
+	{
+		restartWithoutSegments();
+
+		return;
+	}
+
+	bool isValid(writeSegmentData(index, true));
+
+	while (isValid && reply->bytesAvailable() > 0 && m_segments.at(index).offset < m_segments.at(index).end && !m_writes.isEmpty())
+	{
+		waitForWrites();
+
+		isValid = writeSegmentData(index, true);
+	}
+
+	if (!isValid)
+	{
+		handleDownloadError(QNetworkReply::UnknownContentError);
+
+		return;
+	}
+
+	updateSegmentsProgress();
+
+	if (m_segments.at(index).offset >= m_segments.at(index).end)
+	{
+		finishSegment(index);
+	}
+	else if (m_segments.at(index).bytesReceived > 0)
+	{
+		reply->disconnect(this);
+
+		reply->deleteLater();
+
+		startSegment(index);
+	}
+	else
+	{
+		handleDownloadError(QNetworkReply::UnknownContentError);
+	}
+}
+
+void Transfer::handleWritesFinished()
+{
+	removeFinishedWrites();
+	processData();
+}
+
+void Transfer::handleHashesFinalized()
+{
+	m_hashResults = m_hashesWatcher->result();
+
+	m_hashesWatcher->deleteLater();
+	m_hashesWatcher = nullptr;
+
+	emit changed();
+}
+
 void Transfer::setOpenCommand(const QString &command)
 {
 	m_openCommand = command;
@@ -570,20 +1276,83 @@ void Transfer::setOpenCommand(const QString &command)
 			m_device = nullptr;
 		}
 
-		openTarget();
+		openTarget();
+	}
+}
+
+void Transfer::setHash(const QByteArray &hash, QCryptographicHash::Algorithm algorithm)
+{
+	if (!hash.isEmpty())
+	{
+		m_hashes[algorithm] = hash;
+	}
+	else if (m_hashes.contains(algorithm))
+	{
+		m_hashes.remove(algorithm);
+	}
+
+	if (m_state != FinishedState && m_hashedBytes > 0 && !m_hashers.contains(algorithm) && !hash.isEmpty())
+	{
+		resetHashes();
+	}
+}
+
+void Transfer::setPriority(TransferPriority priority)
+{
+	if (priority != m_priority)
+	{
+		m_priority = priority;
+
+		emit changed();
+	}
+}
+
+void Transfer::setSpeedLimit(qint64 limit)
+{
+	limit = qMax(static_cast<qint64>(0), limit);
+
+	if (limit != m_speedLimit)
+	{
+		m_speedLimit = limit;
+		m_bandwidthTokens = limit;
+
+		emit changed();
 	}
 }
 
-void Transfer::setHash(const QByteArray &hash, QCryptographicHash::Algorithm algorithm)
+void Transfer::setQueued(bool isQueued)
 {
-	if (!hash.isEmpty())
+	if (isQueued && m_state == RunningState && isResumable())
 	{
-		m_hashes[algorithm] = hash;
+		stop();
+
+		m_isQueued = true;
+
+		emit changed();
+
+		return;
 	}
-	else if (m_hashes.contains(algorithm))
+
+	if (isQueued == m_isQueued)
 	{
-		m_hashes.remove(algorithm);
+		return;
+	}
+
+	m_isQueued = isQueued;
+
+	if (!m_isQueued)
+	{
+		if (m_state == ErrorState)
+		{
+			resume();
+		}
+		else
+		{
+			processData();
+		}
 	}
+
+	emit changed();
 }
 
 void Transfer::setUpdateInterval(int interval)
@@ -669,6 +1438,17 @@ QString Transfer::getSuggestedFileName()
 	return fileName;
 }
 
+QThreadPool* Transfer::getWriterThreadPool()
+{
+	if (!m_writerThreadPool)
+	{
+		m_writerThreadPool = new QThreadPool(QCoreApplication::instance());
+		m_writerThreadPool->setMaxThreadCount(1);
+	}
+
+	return m_writerThreadPool;
+}
+
 QString Transfer::getTarget() const
 {
 	return m_target;
@@ -711,6 +1491,40 @@ qint64 Transfer::getBytesTotal() const
 	return m_bytesTotal;
 }
 
+qint64 Transfer::getSpeedLimit() const
+{
+	return m_speedLimit;
+}
+
+qint64 Transfer::getReadLimit(QNetworkReply *reply, qint64 size) const
+{
+	if (reply->isFinished())
+	{
+		return size;
+	}
+
+	if (m_isQueued)
+	{
+		return 0;
+	}
+
+	qint64 limit(size);
+
+	if (m_speedLimit > 0)
+	{
+		limit = qMin(limit, m_bandwidthTokens);
+	}
+
+	const qint64 bandwidth(TransfersManager::getAvailableBandwidth());
+
+	if (bandwidth >= 0)
+	{
+		limit = qMin(limit, bandwidth);
+	}
+
+	return limit;
+}
+
 Transfer::TransferOptions Transfer::getOptions() const
 {
 	return m_options;
@@ -721,46 +1535,168 @@ Transfer::TransferState Transfer::getState() const
 	return m_state;
 }
 
+Transfer::TransferPriority Transfer::getPriority() const
+{
+	return m_priority;
+}
+
 int Transfer::getRemainingTime() const
 {
 	return m_remainingTime;
 }
 
-bool Transfer::verifyHashes() const
+int Transfer::getConnectionsAmount() const
 {
-	if (getState() != FinishedState)
+	int amount(0);
+
+	for (int i = 0; i < m_segments.count(); ++i)
+	{
+		if (m_segments.at(i).offset < m_segments.at(i).end)
+		{
+			++amount;
+		}
+	}
+
+	return qMax(1, amount);
+}
+
+QStringList Transfer::getSegments() const
+{
+	QStringList segments;
+
+	for (int i = 0; i < m_segments.count(); ++i)
+	{
+		if (m_segments.at(i).offset < m_segments.at(i).end)
+		{
+			segments.append(QStringLiteral("%1-%2").arg(m_segments.at(i).offset).arg(m_segments.at(i).end));
+		}
+	}
+
+	return segments;
+}
+
+int Transfer::findSegment(QNetworkReply *reply) const
+{
+	if (!reply)
+	{
+		return -1;
+	}
+
+	for (int i = 0; i < m_segments.count(); ++i)
+	{
+		if (m_segments.at(i).reply == reply)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+QByteArray Transfer::getValidator(QNetworkReply *reply)
+{
+	const QByteArray entityTag(reply->rawHeader(QByteArrayLiteral("ETag")).trimmed());
+
+	if (!entityTag.isEmpty() && !entityTag.startsWith(QByteArrayLiteral("W/")))
+	{
+		return entityTag;
+	}
+
+	return reply->rawHeader(QByteArrayLiteral("Last-Modified")).trimmed();
+}
+
+bool Transfer::isSegmentReplyValid(int index) const
+{
+	const TransferSegment &segment(m_segments.at(index));
+
+	if (segment.reply == m_reply || segment.bytesReceived > 0)
+	{
+		return true;
+	}
+
+	if (segment.reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() != 206)
 	{
 		return false;
 	}
 
-	QFile file(getTarget());
+	const QRegularExpressionMatch match(QRegularExpression(QLatin1String("^bytes\\s+(\\d+)-(\\d+)/(\\d+)$")).match(QString::fromLatin1(segment.reply->rawHeader(QByteArrayLiteral("Content-Range")).trimmed())));
+
+	return (match.hasMatch() && match.captured(1).toLongLong() == segment.offset && match.captured(2).toLongLong() >= segment.offset && match.captured(3).toLongLong() == m_bytesTotal);
+}
+
+bool Transfer::isResumable() const
+{
+	return (m_bytesTotal > 0 && m_device && !m_device->inherits("QTemporaryFile") && !m_options.testFlag(CanAutoDeleteOption) && (!m_segments.isEmpty() || (m_reply && m_reply->rawHeader(QByteArrayLiteral("Accept-Ranges")).trimmed().toLower() == QByteArrayLiteral("bytes"))));
+}
 
-	if (!file.open(QIODevice::ReadOnly))
+bool Transfer::verifyHashes() const
+{
+	if (getState() != FinishedState)
 	{
 		return false;
 	}
 
+	QHash<QCryptographicHash::Algorithm, QCryptographicHash*> hashers;
 	QHash<QCryptographicHash::Algorithm, QByteArray>::const_iterator iterator;
-	bool isValid(true);
 
 	for (iterator = m_hashes.constBegin(); iterator != m_hashes.constEnd(); ++iterator)
 	{
-		QCryptographicHash hash(iterator.key());
-		hash.addData(&file);
+		if (!m_hashResults.contains(iterator.key()))
+		{
+			hashers[iterator.key()] = new QCryptographicHash(iterator.key());
+		}
+	}
+
+	QHash<QCryptographicHash::Algorithm, QByteArray> results(m_hashResults);
+
+	if (!hashers.isEmpty())
+	{
+		QFile file(getTarget());
 
-		if (hash.result() != iterator.value())
+		if (!file.open(QIODevice::ReadOnly))
 		{
-			isValid = false;
+			qDeleteAll(hashers);
 
-			break;
+			return false;
+		}
+
+		while (!file.atEnd())
+		{
+			const QByteArray data(file.read(TRANSFER_HASH_CHUNK_SIZE));
+			QHash<QCryptographicHash::Algorithm, QCryptographicHash*>::iterator hashersIterator;
+
+			if (data.isEmpty())
+			{
+				break;
+			}
+
+			for (hashersIterator = hashers.begin(); hashersIterator != hashers.end(); ++hashersIterator)
+			{
+				hashersIterator.value()->addData(data);
+			}
 		}
 
-		file.seek(0);
+		file.close();
+
+		QHash<QCryptographicHash::Algorithm, QCryptographicHash*>::const_iterator hashersIterator;
+
+		for (hashersIterator = hashers.constBegin(); hashersIterator != hashers.constEnd(); ++hashersIterator)
+		{
+			results[hashersIterator.key()] = hashersIterator.value()->result();
+		}
+
+		qDeleteAll(hashers);
 	}
 
-	file.close();
+	for (iterator = m_hashes.constBegin(); iterator != m_hashes.constEnd(); ++iterator)
+	{
+		if (results.value(iterator.key()) != iterator.value())
+		{
+			return false;
+		}
+	}
 
-	return isValid;
+	return true;
 }
 
 bool Transfer::isArchived() const
@@ -768,6 +1704,53 @@ bool Transfer::isArchived() const
 	return m_isArchived;
 }
 
+bool Transfer::isQueued() const
+{
+	return m_isQueued;
+}
+
+bool Transfer::writeSegmentData(int index, bool canWritePartialBlock)
+{
+	TransferSegment &segment(m_segments[index]);
+	QNetworkReply *reply(segment.reply);
+
+	removeFinishedWrites();
+
+	while (segment.offset < segment.end && reply->bytesAvailable() > 0 && m_writes.count() < TRANSFER_WRITE_QUEUE_LIMIT)
+	{
+		const qint64 blockSize(qMin(static_cast<qint64>(TRANSFER_WRITE_BLOCK_SIZE), (segment.end - segment.offset)));
+		const qint64 readLimit(getReadLimit(reply, blockSize));
+
+		if (readLimit <= 0 || (readLimit == blockSize && !canWritePartialBlock && reply->bytesAvailable() < blockSize))
+		{
+			break;
+		}
+
+		const QByteArray data(reply->read(readLimit));
+
+		if (data.isEmpty())
+		{
+			break;
+		}
+
+		updateHashes(segment.offset, data);
+		enqueueWrite(segment.offset, data);
+		consumeBandwidth(data.size());
+
+		segment.offset += data.size();
+		segment.bytesReceived += data.size();
+
+		m_bytesReceivedDifference += data.size();
+	}
+
+	if (segment.offset < segment.end && reply->bytesAvailable() > 0 && m_writes.count() >= TRANSFER_WRITE_QUEUE_LIMIT)
+	{
+		watchWrites();
+	}
+
+	return !m_hasWriteError;
+}
+
 bool Transfer::resume()
 {
 	if (m_state != ErrorState || !QFile::exists(m_target))
@@ -776,12 +1759,55 @@ bool Transfer::resume()
 	}
 
 	m_isArchived = false;
+	m_isQueued = false;
 
 	if (m_bytesTotal == 0)
 	{
 		return restart();
 	}
 
+	if (!m_segments.isEmpty() && (m_validator.isEmpty() || QFileInfo(m_target).size() != m_bytesTotal))
+	{
+		m_segments.clear();
+
+		return restart();
+	}
+
+	if (!m_segments.isEmpty())
+	{
+		QFile *file(new QFile(m_target));
+
+		if (!file->open(QIODevice::ReadWrite))
+		{
+			file->deleteLater();
+
+			return false;
+		}
+
+		m_state = RunningState;
+		m_device = file;
+		m_timeStarted = QDateTime::currentDateTimeUtc();
+		m_timeFinished = {};
+		m_hasWriteError = false;
+
+		for (int i = 0; i < m_segments.count(); ++i)
+		{
+			if (m_segments.at(i).offset < m_segments.at(i).end)
+			{
+				startSegment(i);
+			}
+		}
+
+		if (m_updateTimer == 0 && m_updateInterval > 0)
+		{
+			m_updateTimer = startTimer(m_updateInterval);
+		}
+
+		return true;
+	}
+
+	m_segments.clear();
+
 	QFile *file(new QFile(m_target));
 
 	if (!file->open(QIODevice::WriteOnly | QIODevice::Append))
@@ -796,14 +1822,24 @@ bool Transfer::resume()
 	m_timeStarted = QDateTime::currentDateTimeUtc();
 	m_timeFinished = {};
 	m_bytesStart = file->size();
+	m_writeOffset = file->size();
+	m_hasWriteError = false;
 
 	QNetworkRequest request;
 	request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
 	request.setHeader(QNetworkRequest::UserAgentHeader, NetworkManagerFactory::getUserAgent());
 	request.setRawHeader(QByteArrayLiteral("Range"), QStringLiteral("bytes=%1-").arg(file->size()).toLatin1());
+
+	if (!m_validator.isEmpty())
+	{
+		request.setRawHeader(QByteArrayLiteral("If-Range"), m_validator);
+	}
+
+	request.setPriority(QNetworkRequest::LowPriority);
 	request.setUrl(m_source);
 
 	m_reply = NetworkManagerFactory::getNetworkManager(m_options.testFlag(IsPrivateOption))->get(request);
+	m_reply->setReadBufferSize(TRANSFER_READ_BUFFER_SIZE);
 
 	handleDataAvailable();
 
@@ -823,9 +1859,12 @@ bool Transfer::resume()
 bool Transfer::restart()
 {
 	stop();
+	resetHashes();
 
 	m_isArchived = false;
 
+	m_segments.clear();
+
 	QFile *file(new QFile(m_target));
 
 	if (!file->open(QIODevice::WriteOnly))
@@ -840,13 +1879,17 @@ bool Transfer::restart()
 	m_timeStarted = QDateTime::currentDateTimeUtc();
 	m_timeFinished = {};
 	m_bytesStart = 0;
+	m_writeOffset = 0;
+	m_hasWriteError = false;
 
 	QNetworkRequest request;
 	request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
 	request.setHeader(QNetworkRequest::UserAgentHeader, NetworkManagerFactory::getUserAgent());
+	request.setPriority(QNetworkRequest::LowPriority);
 	request.setUrl(m_source);
 
 	m_reply = NetworkManagerFactory::getNetworkManager(m_options.testFlag(IsPrivateOption))->get(request);
+	m_reply->setReadBufferSize(TRANSFER_READ_BUFFER_SIZE);
 
 	handleDataAvailable();
 
@@ -865,7 +1908,7 @@ bool Transfer::restart()
 
 bool Transfer::setTarget(const QString &target, bool canOverwriteExisting)
 {
-	if (m_target == target)
+	if (m_target == target || (m_state == RunningState && !m_segments.isEmpty()))
 	{
 		return false;
 	}
@@ -940,6 +1983,8 @@ bool Transfer::setTarget(const QString &target, bool canOverwriteExisting)
 			disconnect(m_reply, &QNetworkReply::readyRead, this, &Transfer::handleDataAvailable);
 		}
 
+		waitForWrites();
+
 		m_device->reset();
 
 		file->write(m_device->readAll());
@@ -949,6 +1994,7 @@ bool Transfer::setTarget(const QString &target, bool canOverwriteExisting)
 	}
 
 	m_device = file;
+	m_writeOffset = file->pos();
 
 	handleDataAvailable();
 
@@ -959,13 +2005,16 @@ bool Transfer::setTarget(const QString &target, bool canOverwriteExisting)
 	else
 	{
 		connect(m_reply, &QNetworkReply::readyRead, this, &Transfer::handleDataAvailable);
+
+		startSegments();
 	}
 
 	return false;
 }
 
 TransfersManager::TransfersManager(QObject *parent) : QObject(parent),
-	m_saveTimer(0)
+	m_saveTimer(0),
+	m_schedulerTimer(0)
 {
 }
 
@@ -987,6 +2036,10 @@ void TransfersManager::timerEvent(QTimerEvent *event)
 
 		save();
 	}
+	else if (event->timerId() == m_schedulerTimer)
+	{
+		updateSchedule();
+	}
 }
 
 void TransfersManager::scheduleSave()
@@ -1008,6 +2061,78 @@ void TransfersManager::scheduleSave()
 	}
 }
 
+void TransfersManager::scheduleTransfers()
+{
+	if (m_instance && m_instance->m_schedulerTimer == 0)
+	{
+		m_instance->m_schedulerTimer = m_instance->startTimer(TRANSFERS_SCHEDULER_INTERVAL);
+	}
+}
+
+void TransfersManager::updateSchedule()
+{
+	QVector<Transfer*> transfers;
+
+	for (int i = 0; i < m_transfers.count(); ++i)
+	{
+		Transfer *transfer(m_transfers.at(i));
+
+		if ((transfer->m_state == Transfer::RunningState && (transfer->m_reply || !transfer->m_segments.isEmpty())) || (transfer->m_state == Transfer::ErrorState && transfer->m_isQueued))
+		{
+			transfers.append(transfer);
+		}
+	}
+
+	if (transfers.isEmpty())
+	{
+		killTimer(m_schedulerTimer);
+
+		m_schedulerTimer = 0;
+
+		return;
+	}
+
+	std::stable_sort(transfers.begin(), transfers.end(), [&](Transfer *first, Transfer *second)
+	{
+		if (first->m_priority != second->m_priority)
+		{
+			return (first->m_priority > second->m_priority);
+		}
+
+		return (!first->m_isQueued && second->m_isQueued);
+	});
+
+	const qint64 speedLimit(SettingsManager::getOption(SettingsManager::Browser_TransferSpeedLimitOption).toLongLong() * 1024);
+	const int transfersLimit(SettingsManager::getOption(SettingsManager::Browser_TransfersLimitOption).toInt());
+	const int hostLimit(SettingsManager::getOption(SettingsManager::Browser_TransfersPerHostLimitOption).toInt());
+	QHash<QString, int> hostConnections;
+	int transfersAmount(0);
+
+	m_bandwidthTokens = ((speedLimit > 0) ? qMin(speedLimit, (m_bandwidthTokens + ((speedLimit * TRANSFERS_SCHEDULER_INTERVAL) / 1000))) : 0);
+
+	for (int i = 0; i < transfers.count(); ++i)
+	{
+		Transfer *transfer(transfers.at(i));
+		const QString host(transfer->getSource().host());
+		const int connectionsAmount(transfer->getConnectionsAmount());
+
+		if ((transfer->m_state == Transfer::RunningState && !transfer->m_isQueued && !transfer->isResumable()) || ((transfersLimit <= 0 || transfersAmount < transfersLimit) && (hostLimit <= 0 || !hostConnections.contains(host) || (hostConnections[host] + connectionsAmount) <= hostLimit)))
+		{
+			++transfersAmount;
+
+			hostConnections[host] += connectionsAmount;
+
+			transfer->setQueued(false);
+		}
+		else
+		{
+			transfer->setQueued(true);
+		}
+
+		transfer->refillBandwidth(TRANSFERS_SCHEDULER_INTERVAL);
+	}
+}
+
 void TransfersManager::updateRunningTransfersState()
 {
 	bool hasRunningTransfers(false);
@@ -1041,6 +2166,8 @@ void TransfersManager::addTransfer(Transfer *transfer)
 	connect(transfer, &Transfer::changed, m_instance, &TransfersManager::handleTransferChanged);
 	connect(transfer, &Transfer::stopped, m_instance, &TransfersManager::handleTransferStopped);
 
+	scheduleTransfers();
+
 	if (transfer->getOptions().testFlag(Transfer::CanNotifyOption) && transfer->getState() != Transfer::CancelledState)
 	{
 		emit m_instance->transferStarted(transfer);
@@ -1094,6 +2221,33 @@ void TransfersManager::save()
 		history.setValue(QStringLiteral("%1/bytesTotal").arg(entry), m_transfers.at(i)->getBytesTotal());
 		history.setValue(QStringLiteral("%1/bytesReceived").arg(entry), m_transfers.at(i)->getBytesReceived());
 
+		const QStringList segments(m_transfers.at(i)->getSegments());
+
+		if (!segments.isEmpty())
+		{
+			history.setValue(QStringLiteral("%1/segments").arg(entry), segments);
+		}
+
+		if (!m_transfers.at(i)->m_validator.isEmpty())
+		{
+			history.setValue(QStringLiteral("%1/validator").arg(entry), QString::fromLatin1(m_transfers.at(i)->m_validator));
+		}
+
+		if (m_transfers.at(i)->getPriority() != Transfer::NormalPriority)
+		{
+			history.setValue(QStringLiteral("%1/priority").arg(entry), m_transfers.at(i)->getPriority());
+		}
+
+		if (m_transfers.at(i)->getSpeedLimit() > 0)
+		{
+			history.setValue(QStringLiteral("%1/speedLimit").arg(entry), m_transfers.at(i)->getSpeedLimit());
+		}
+
+		if (m_transfers.at(i)->isQueued())
+		{
+			history.setValue(QStringLiteral("%1/queued").arg(entry), true);
+		}
+
 		++entry;
 	}
 
@@ -1169,6 +2323,7 @@ void TransfersManager::handleTransferChanged()
 	if (transfer)
 	{
 		scheduleSave();
+		scheduleTransfers();
 		updateRunningTransfersState();
 
 		emit transferChanged(transfer);
@@ -1191,6 +2346,11 @@ void TransfersManager::handleTransferStopped()
 	}
 }
 
+void TransfersManager::consumeBandwidth(qint64 amount)
+{
+	m_bandwidthTokens = qMax(static_cast<qint64>(0), (m_bandwidthTokens - amount));
+}
+
 TransfersManager* TransfersManager::getInstance()
 {
 	return m_instance;
@@ -1202,6 +2362,7 @@ Transfer* TransfersManager::startTransfer(const QUrl &source, const QString &tar
 	request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
 	request.setAttribute(QNetworkRequest::FollowRedirectsAttribute, true);
 	request.setHeader(QNetworkRequest::UserAgentHeader, NetworkManagerFactory::getUserAgent());
+	request.setPriority(QNetworkRequest::LowPriority);
 	request.setUrl(QUrl(source));
 
 	Transfer *transfer(new Transfer(options, m_instance));
@@ -1314,6 +2475,11 @@ TransfersManager::ActiveTransfersInformation TransfersManager::getActiveTransfer
 	return information;
 }
 
+qint64 TransfersManager::getAvailableBandwidth()
+{
+	return ((SettingsManager::getOption(SettingsManager::Browser_TransferSpeedLimitOption).toInt() > 0) ? m_bandwidthTokens : -1);
+}
+
 bool TransfersManager::removeTransfer(Transfer *transfer, bool keepFile)
 {
 	if (!transfer || !m_transfers.contains(transfer))
@@ -20,13 +20,18 @@
 #ifndef OTTER_TRANSFERSMANAGER_H
 #define OTTER_TRANSFERSMANAGER_H
 
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QFile>
+#include <QtCore/QFutureWatcher>
 #include <QtCore/QMimeType>
 #include <QtCore/QPointer>
 #include <QtCore/QQueue>
 #include <QtCore/QSettings>
+#include <QtCore/QVector>
 #include <QtNetwork/QNetworkReply>
 
+class QThreadPool;
+
 namespace Otter
 {
 
@@ -60,9 +65,18 @@ public:
 		FinishedState
 	};
 
+	enum TransferPriority
+	{
+		LowPriority = 0,
+		NormalPriority,
+		HighPriority
+	};
+
 	~Transfer();
 
 	void setHash(const QByteArray &hash, QCryptographicHash::Algorithm algorithm);
+	void setPriority(TransferPriority priority);
+	void setSpeedLimit(qint64 limit);
 	virtual void setUpdateInterval(int interval);
 	virtual QUrl getSource() const;
 	virtual QString getSuggestedFileName();
@@ -74,11 +88,14 @@ public:
 	virtual qint64 getSpeed() const;
 	virtual qint64 getBytesReceived() const;
 	virtual qint64 getBytesTotal() const;
+	qint64 getSpeedLimit() const;
 	TransferOptions getOptions() const;
 	virtual TransferState getState() const;
+	TransferPriority getPriority() const;
 	virtual int getRemainingTime() const;
 	bool verifyHashes() const;
 	bool isArchived() const;
+	bool isQueued() const;
 
 public slots:
 	void openTarget() const;
@@ -90,11 +107,49 @@ public slots:
 	virtual bool setTarget(const QString &target, bool canOverwriteExisting = false);
 
 protected:
+	struct TransferSegment final
+	{
+		QPointer<QNetworkReply> reply;
+		QElapsedTimer timer;
+		qint64 offset = 0;
+		qint64 end = 0;
+		qint64 bytesReceived = 0;
+	};
+
 	explicit Transfer(TransferOptions options = CanAskForPathOption, QObject *parent = nullptr);
 	explicit Transfer(const QSettings &settings, QObject *parent = nullptr);
 
 	void timerEvent(QTimerEvent *event) override;
 	void start(QNetworkReply *reply, const QString &target);
+	void startSegments();
+	void startSegment(int index);
+	void stopSegments();
+	void finishSegment(int index);
+	void finishSegmentedTransfer();
+	void updateSegmentsProgress();
+	void writeReplyData(bool canWritePartialBlock);
+	void enqueueWrite(qint64 offset, const QByteArray &data);
+	void watchWrites();
+	void removeFinishedWrites();
+	void waitForWrites();
+	void processSegment(int index);
+	void restartWithoutSegments();
+	void processData();
+	void consumeBandwidth(qint64 amount);
+	void refillBandwidth(int interval);
+	void setQueued(bool isQueued);
+	void updateHashes(qint64 offset, const QByteArray &data);
+	void resetHashes();
+	void finalizeHashes();
+	QStringList getSegments() const;
+	int findSegment(QNetworkReply *reply) const;
+	static QByteArray getValidator(QNetworkReply *reply);
+	bool isSegmentReplyValid(int index) const;
+	bool isResumable() const;
+	static QThreadPool* getWriterThreadPool();
+	qint64 getReadLimit(QNetworkReply *reply, qint64 size) const;
+	int getConnectionsAmount() const;
+	bool writeSegmentData(int index, bool canWritePartialBlock);
 
 protected slots:
 	void markAsStarted();
@@ -103,10 +158,16 @@ protected slots:
 	void handleDataAvailable();
 	void handleDownloadFinished();
 	void handleDownloadError(QNetworkReply::NetworkError error);
+	void handleSegmentDataAvailable();
+	void handleSegmentFinished();
+	void handleWritesFinished();
+	void handleHashesFinalized();
 
 private:
 	QPointer<QNetworkReply> m_reply;
 	QPointer<QFile> m_device;
+	QFutureWatcher<bool> *m_writesWatcher;
+	QFutureWatcher<QHash<QCryptographicHash::Algorithm, QByteArray> > *m_hashesWatcher;
 	QUrl m_source;
 	QString m_target;
 	QString m_openCommand;
@@ -114,20 +175,34 @@ private:
 	QDateTime m_timeStarted;
 	QDateTime m_timeFinished;
 	QMimeType m_mimeType;
+	QByteArray m_validator;
 	QHash<QCryptographicHash::Algorithm, QByteArray> m_hashes;
+	QHash<QCryptographicHash::Algorithm, QByteArray> m_hashResults;
+	QHash<QCryptographicHash::Algorithm, QCryptographicHash*> m_hashers;
+	QVector<TransferSegment> m_segments;
+	QQueue<QFuture<bool> > m_writes;
 	QQueue<qint64> m_speeds;
 	qint64 m_speed;
 	qint64 m_bytesStart;
 	qint64 m_bytesReceivedDifference;
 	qint64 m_bytesReceived;
 	qint64 m_bytesTotal;
+	qint64 m_hashedBytes;
+	qint64 m_writeOffset;
+	qint64 m_speedLimit;
+	qint64 m_bandwidthTokens;
 	TransferOptions m_options;
 	TransferState m_state;
+	TransferPriority m_priority;
 	int m_updateTimer;
 	int m_updateInterval;
 	int m_remainingTime;
 	bool m_isSelectingPath;
 	bool m_isArchived;
+	bool m_hasWriteError;
+	bool m_isQueued;
+
+	static QThreadPool *m_writerThreadPool;
 
 signals:
 	void progressChanged(qint64 bytesReceived, qint64 bytesTotal);
@@ -170,7 +245,11 @@ protected:
 
 	void timerEvent(QTimerEvent *event) override;
 	void scheduleSave();
+	void updateSchedule();
 	void updateRunningTransfersState();
+	static void scheduleTransfers();
+	static void consumeBandwidth(qint64 amount);
+	static qint64 getAvailableBandwidth();
 
 protected slots:
 	void save();
@@ -181,10 +260,12 @@ protected slots:
 
 private:
 	int m_saveTimer;
+	int m_schedulerTimer;
 
 	static TransfersManager *m_instance;
 	static QVector<Transfer*> m_transfers;
 	static QVector<Transfer*> m_privateTransfers;
+	static qint64 m_bandwidthTokens;
 	static bool m_isInitilized;
 	static bool m_hasRunningTransfers;
 
@@ -195,6 +276,8 @@ signals:
 	void transferStopped(Transfer *transfer);
 	void transferRemoved(Transfer *transfer);
 	void transfersChanged();
+
+friend class Transfer;
 };
 
 }
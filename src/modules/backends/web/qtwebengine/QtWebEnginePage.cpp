@@ -32,6 +32,8 @@
 #include "../../../../ui/LineEditWidget.h"
 
 #include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
 #include <QtCore/QRegularExpression>
 #include <QtWebEngineWidgets/QWebEngineHistory>
 #include <QtWebEngineWidgets/QWebEngineProfile>
@@ -172,16 +174,19 @@ void QtWebEnginePage::handleLoadFinished()
 			const QUrl url(m_widget->getUrl());
 			const ContentFiltersManager::CosmeticFiltersResult cosmeticFilters(ContentFiltersManager::getCosmeticFilters(ContentFiltersManager::getProfileIdentifiers(m_widget->getOption(SettingsManager::ContentBlocking_ProfilesOption).toStringList()), url));
 
-			if (!cosmeticFilters.rules.isEmpty() || !cosmeticFilters.exceptions.isEmpty())
+			if (!cosmeticFilters.styleSheet.isEmpty())
 			{
-				QFile file(QLatin1String(":/modules/backends/web/qtwebengine/resources/hideElements.js"));
-
-				if (file.open(QIODevice::ReadOnly))
+				if (!cosmeticFilters.styleSheet.isSharedWith(m_cosmeticFiltersStyleSheet))
 				{
-					runJavaScript(QString::fromLatin1(file.readAll()).arg(createJavaScriptList(cosmeticFilters.exceptions), createJavaScriptList(cosmeticFilters.rules)));
+					const QString styleSheetArray(QString::fromUtf8(QJsonDocument(QJsonArray({cosmeticFilters.styleSheet})).toJson(QJsonDocument::Compact)));
+					QString styleSheet(styleSheetArray.mid(1, (styleSheetArray.length() - 2)));
+					styleSheet.replace(QChar(0x2028), QLatin1String("\\u2028")).replace(QChar(0x2029), QLatin1String("\\u2029"));
 
-					file.close();
+					m_cosmeticFiltersStyleSheet = cosmeticFilters.styleSheet;
+					m_cosmeticFiltersScript = createScriptSource(QLatin1String("hideElements"), {styleSheet});
 				}
+
+				runJavaScript(m_cosmeticFiltersScript);
 			}
 
 			const QStringList blockedRequests(m_widget->getBlockedElements());
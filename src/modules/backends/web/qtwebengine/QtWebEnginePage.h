@@ -82,6 +82,8 @@ private:
 	WebWidget::SslInformation m_sslInformation;
 	QVector<QtWebEnginePage*> m_popups;
 	QVector<HistoryEntryInformation> m_history;
+	QString m_cosmeticFiltersStyleSheet;
+	QString m_cosmeticFiltersScript;
 	NavigationType m_previousNavigationType;
 	bool m_isIgnoringJavaScriptPopups;
 	bool m_isViewingMedia;
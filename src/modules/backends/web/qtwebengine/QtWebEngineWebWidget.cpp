@@ -70,6 +70,7 @@ QtWebEngineWebWidget::QtWebEngineWebWidget(const QVariantMap &parameters, WebBac
 	m_requestInterceptor(new QtWebEngineUrlRequestInterceptor(this)),
 	m_loadingState(FinishedLoadingState),
 	m_canGoForwardValue(UnknownValue),
+	m_isModifiedValue(UnknownValue),
 	m_documentLoadingProgress(0),
 	m_focusProxyTimer(0),
 	m_updateNavigationActionsTimer(0),
@@ -166,6 +167,7 @@ void QtWebEngineWebWidget::hideEvent(QHideEvent *event)
 	killTimer(m_focusProxyTimer);
 
 	m_focusProxyTimer = 0;
+	m_isModifiedValue = UnknownValue;
 }
 
 void QtWebEngineWebWidget::focusInEvent(QFocusEvent *event)
@@ -910,6 +912,7 @@ void QtWebEngineWebWidget::handleLoadStarted()
 	m_searchEngines.clear();
 	m_watchedChanges.clear();
 	m_loadingState = OngoingLoadingState;
+	m_isModifiedValue = UnknownValue;
 	m_documentLoadingProgress = 0;
 
 	setStatusMessage({});
@@ -1553,20 +1556,14 @@ QIcon QtWebEngineWebWidget::getIcon() const
 	return (icon.isNull() ? ThemesManager::createIcon(QLatin1String("tab")) : icon);
 }
 
-QPixmap QtWebEngineWebWidget::createThumbnail(const QSize &size)
+QPixmap QtWebEngineWebWidget::renderThumbnail(const QSize &size)
 {
 	if (!m_webView)
 	{
 		return {};
 	}
 
-	if ((size.isNull() || size == m_thumbnail.size()) && ((!m_thumbnail.isNull() && qFuzzyCompare(m_thumbnail.devicePixelRatio(), devicePixelRatio())) || m_loadingState == OngoingLoadingState))
-	{
-		return m_thumbnail;
-	}
-
-	const QSize thumbnailSize(size.isValid() ? size : QSize(260, 170));
-	const qreal thumbnailAspectRatio(static_cast<qreal>(thumbnailSize.width()) / thumbnailSize.height());
+	const qreal thumbnailAspectRatio(static_cast<qreal>(size.width()) / size.height());
 	const QSize contentsSize(m_webView->size());
 	const qreal contentsAspectRatio(static_cast<qreal>(contentsSize.width()) / contentsSize.height());
 	QPixmap pixmap(m_webView->grab(QRect({0, 0}, contentsSize)));
@@ -1585,14 +1582,9 @@ QPixmap QtWebEngineWebWidget::createThumbnail(const QSize &size)
 		}
 	}
 
-	pixmap = pixmap.scaled((thumbnailSize * devicePixelRatio()), Qt::KeepAspectRatio, Qt::SmoothTransformation);
+	pixmap = pixmap.scaled((size * devicePixelRatio()), Qt::KeepAspectRatio, Qt::SmoothTransformation);
 	pixmap.setDevicePixelRatio(devicePixelRatio());
 
-	if (size.isNull())
-	{
-		m_thumbnail = pixmap;
-	}
-
 	return pixmap;
 }
 
@@ -1813,6 +1805,16 @@ bool QtWebEngineWebWidget::isFullScreen() const
 	return m_isFullScreen;
 }
 
+bool QtWebEngineWebWidget::isModified() const
+{
+	m_page->runJavaScript(QLatin1String("(function() { var elements = document.querySelectorAll('input, select, textarea'); for (var i = 0; i < elements.length; ++i) { var element = elements[i]; if (element.tagName.toLowerCase() == 'select') { for (var j = 0; j < element.options.length; ++j) { if (element.options[j].selected != element.options[j].defaultSelected) { return true; } } } else if (element.type == 'checkbox' || element.type == 'radio') { if (element.checked != element.defaultChecked) { return true; } } else if (element.type != 'button' && element.type != 'hidden' && element.type != 'reset' && element.type != 'submit' && element.value != element.defaultValue) { return true; } } return false; })()"), [&](const QVariant &result)
+	{
+		m_isModifiedValue = (result.toBool() ? TrueValue : FalseValue);
+	});
+
+	return (m_isModifiedValue != FalseValue);
+}
+
 bool QtWebEngineWebWidget::isInspecting() const
 {
 	return (m_inspectorView && m_inspectorView->isVisible());
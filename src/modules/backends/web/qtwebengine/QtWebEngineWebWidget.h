@@ -73,7 +73,6 @@ public:
 	QVariant getPageInformation(PageInformation key) const override;
 	QUrl getUrl() const override;
 	QIcon getIcon() const override;
-	QPixmap createThumbnail(const QSize &size = {}) override;
 	QPoint getScrollPosition() const override;
 	LinkUrl getActiveFrame() const override;
 	LinkUrl getActiveImage() const override;
@@ -95,6 +94,7 @@ public:
 	bool isAudible() const override;
 	bool isAudioMuted() const override;
 	bool isFullScreen() const override;
+	bool isModified() const override;
 	bool isPrivate() const override;
 	bool eventFilter(QObject *object, QEvent *event) override;
 
@@ -124,6 +124,7 @@ protected:
 	void setHistory(QDataStream &stream);
 	void setOptions(const QHash<int, QVariant> &options, const QStringList &excludedOptions = {}) override;
 	QWebEnginePage* getPage() const;
+	QPixmap renderThumbnail(const QSize &size) override;
 	QString parsePosition(const QString &script, const QPoint &position) const;
 	QDateTime getLastUrlClickTime() const;
 	QStringList getBlockedElements() const;
@@ -163,7 +164,6 @@ private:
 	QtWebEngineUrlRequestInterceptor *m_requestInterceptor;
 	QString m_findInPageText;
 	QDateTime m_lastUrlClickTime;
-	QPixmap m_thumbnail;
 	HitTestResult m_hitResult;
 	QHash<QNetworkReply*, QPointer<SourceViewerWebWidget> > m_viewSourceReplies;
 	QMultiMap<QString, QString> m_metaData;
@@ -174,6 +174,7 @@ private:
 	QVector<bool> m_watchedChanges;
 	LoadingState m_loadingState;
 	TrileanValue m_canGoForwardValue;
+	mutable TrileanValue m_isModifiedValue;
 	int m_documentLoadingProgress;
 	int m_focusProxyTimer;
 	int m_updateNavigationActionsTimer;
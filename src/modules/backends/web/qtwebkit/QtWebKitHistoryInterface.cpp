@@ -19,18 +19,41 @@
 
 #include "QtWebKitHistoryInterface.h"
 #include "../../../../core/HistoryManager.h"
+#include "../../../../core/Utils.h"
+
+#define VISITED_FILTER_BITS_PER_KEY 10
+#define VISITED_FILTER_HASHES 7
+#define VISITED_FILTER_MINIMUM_CAPACITY 1024
 
 namespace Otter
 {
 
-QtWebKitHistoryInterface::QtWebKitHistoryInterface(QObject *parent) : QWebHistoryInterface(parent)
+QtWebKitHistoryInterface::QtWebKitHistoryInterface(QObject *parent) : QWebHistoryInterface(parent),
+	m_filterAmount(0),
+	m_filterCapacity(0)
 {
-	connect(HistoryManager::getBrowsingHistoryModel(), &HistoryModel::cleared, this, &QtWebKitHistoryInterface::clear);
+	const HistoryModel *model(HistoryManager::getBrowsingHistoryModel());
+
+	updateFilter();
+
+	connect(model, &HistoryModel::cleared, this, &QtWebKitHistoryInterface::clear);
+	connect(model, &HistoryModel::entryAdded, this, &QtWebKitHistoryInterface::handleEntryChanged);
+	connect(model, &HistoryModel::entryModified, this, &QtWebKitHistoryInterface::handleEntryChanged);
 }
 
 void QtWebKitHistoryInterface::clear()
 {
 	m_urls.clear();
+
+	updateFilter();
+}
+
+void QtWebKitHistoryInterface::handleEntryChanged(HistoryModel::Entry *entry)
+{
+	if (entry)
+	{
+		addUrl(entry->getUrl());
+	}
 }
 
 void QtWebKitHistoryInterface::addHistoryEntry(const QString &url)
@@ -42,14 +65,100 @@ void QtWebKitHistoryInterface::addHistoryEntry(const QString &url)
 
 	m_urls.append(url);
 
+	addKey(url);
+
 	if (m_urls.length() > 100)
 	{
 		m_urls.removeAt(0);
 	}
 }
 
+void QtWebKitHistoryInterface::addUrl(const QUrl &url)
+{
+	if (url.isEmpty())
+	{
+		return;
+	}
+
+	const QUrl normalizedUrl(Utils::normalizeUrl(url));
+
+	addKey(url.toString());
+	addKey(url.toString(QUrl::FullyEncoded));
+	addKey(normalizedUrl.toString());
+	addKey(normalizedUrl.toString(QUrl::FullyEncoded));
+}
+
+void QtWebKitHistoryInterface::addKey(const QString &url)
+{
+	if (m_filterAmount >= m_filterCapacity)
+	{
+		updateFilter();
+	}
+
+	const QStringRef key(createKey(url));
+	const uint primaryHash(qHash(key));
+	const uint secondaryHash(qHash(key, 0x9E3779B9) | 1);
+	const uint size(static_cast<uint>(m_filter.size()));
+
+	for (uint i = 0; i < VISITED_FILTER_HASHES; ++i)
+	{
+		m_filter.setBit(static_cast<int>((primaryHash + (i * secondaryHash)) % size));
+	}
+
+	++m_filterAmount;
+}
+
+void QtWebKitHistoryInterface::updateFilter()
+{
+	const HistoryModel *model(HistoryManager::getBrowsingHistoryModel());
+
+	m_filterCapacity = qMax(VISITED_FILTER_MINIMUM_CAPACITY, ((model->rowCount() + m_urls.count()) * 8));
+	m_filterAmount = 0;
+	m_filter = QBitArray(m_filterCapacity * VISITED_FILTER_BITS_PER_KEY);
+
+	for (int i = 0; i < model->rowCount(); ++i)
+	{
+		addUrl(model->index(i, 0).data(HistoryModel::UrlRole).toUrl());
+	}
+
+	for (int i = 0; i < m_urls.count(); ++i)
+	{
+		addKey(m_urls.at(i));
+	}
+}
+
+QStringRef QtWebKitHistoryInterface::createKey(const QString &url)
+{
+	int length(url.indexOf(QLatin1Char('#')));
+
+	if (length < 0)
+	{
+		length = url.length();
+	}
+
+	if (length > 0 && url.at(length - 1) == QLatin1Char('/'))
+	{
+		--length;
+	}
+
+	return url.leftRef(length);
+}
+
 bool QtWebKitHistoryInterface::historyContains(const QString &url) const
 {
+	const QStringRef key(createKey(url));
+	const uint primaryHash(qHash(key));
+	const uint secondaryHash(qHash(key, 0x9E3779B9) | 1);
+	const uint size(static_cast<uint>(m_filter.size()));
+
+	for (uint i = 0; i < VISITED_FILTER_HASHES; ++i)
+	{
+		if (!m_filter.testBit(static_cast<int>((primaryHash + (i * secondaryHash)) % size)))
+		{
+			return false;
+		}
+	}
+
 	return (m_urls.contains(url) || HistoryManager::hasEntry(url));
 }
 
@@ -20,6 +20,9 @@
 #ifndef OTTER_QTWEBKITHISTORYINTERFACE_H
 #define OTTER_QTWEBKITHISTORYINTERFACE_H
 
+#include "../../../../core/HistoryModel.h"
+
+#include <QtCore/QBitArray>
 #include <QtCore/QStringList>
 #include <QtWebKit/QWebHistoryInterface>
 
@@ -36,11 +39,21 @@ public:
 	void addHistoryEntry(const QString &url) override;
 	bool historyContains(const QString &url) const override;
 
+protected:
+	void addUrl(const QUrl &url);
+	void addKey(const QString &url);
+	void updateFilter();
+	static QStringRef createKey(const QString &url);
+
 protected slots:
 	void clear();
+	void handleEntryChanged(HistoryModel::Entry *entry);
 
 private:
 	QStringList m_urls;
+	QBitArray m_filter;
+	int m_filterAmount;
+	int m_filterCapacity;
 };
 
 }
@@ -1419,7 +1419,6 @@ void QtWebKitWebWidget::handleLoadStarted()
 		return;
 	}
 
-	m_thumbnail = {};
 	m_messageToken = QUuid::createUuid().toString();
 	m_canLoadPlugins = (getOption(SettingsManager::Permissions_EnablePluginsOption, getUrl()).toString() == QLatin1String("enabled"));
 	m_loadingState = OngoingLoadingState;
@@ -1451,7 +1450,6 @@ void QtWebKitWebWidget::handleLoadFinished(bool result)
 
 	m_networkManager->handleLoadFinished(result);
 
-	m_thumbnail = {};
 	m_loadingState = FinishedLoadingState;
 
 	updateAmountOfDeferredPlugins();
@@ -2118,14 +2116,8 @@ QIcon QtWebKitWebWidget::getIcon() const
 	return (icon.isNull() ? ThemesManager::createIcon(QLatin1String("tab")) : icon);
 }
 
-QPixmap QtWebKitWebWidget::createThumbnail(const QSize &size)
+QPixmap QtWebKitWebWidget::renderThumbnail(const QSize &size)
 {
-	if ((size.isNull() || size == m_thumbnail.size()) && ((!m_thumbnail.isNull() && qFuzzyCompare(m_thumbnail.devicePixelRatio(), devicePixelRatio())) || m_loadingState == OngoingLoadingState))
-	{
-		return m_thumbnail;
-	}
-
-	const QSize thumbnailSize(size.isValid() ? size : QSize(260, 170));
 	const QSize oldViewportSize(m_page->viewportSize());
 	const QPoint position(m_page->mainFrame()->scrollPosition());
 	const qreal zoom(m_page->mainFrame()->zoomFactor());
@@ -2142,7 +2134,7 @@ QPixmap QtWebKitWebWidget::createThumbnail(const QSize &size)
 		contentsSize.setWidth(2000);
 	}
 
-	contentsSize.setHeight(qRound(thumbnailSize.height() * (static_cast<qreal>(contentsSize.width()) / thumbnailSize.width())));
+	contentsSize.setHeight(qRound(size.height() * (static_cast<qreal>(contentsSize.width()) / size.width())));
 
 	m_page->setViewportSize(contentsSize);
 
@@ -2159,16 +2151,11 @@ QPixmap QtWebKitWebWidget::createThumbnail(const QSize &size)
 
 	painter.end();
 
-	pixmap = pixmap.scaled((thumbnailSize * devicePixelRatio()), Qt::KeepAspectRatio, Qt::SmoothTransformation);
+	pixmap = pixmap.scaled((size * devicePixelRatio()), Qt::KeepAspectRatio, Qt::SmoothTransformation);
 	pixmap.setDevicePixelRatio(devicePixelRatio());
 
 	newView->deleteLater();
 
-	if (size.isNull())
-	{
-		m_thumbnail = pixmap;
-	}
-
 	return pixmap;
 }
 
@@ -2679,6 +2666,11 @@ bool QtWebKitWebWidget::isFullScreen() const
 	return m_isFullScreen;
 }
 
+bool QtWebKitWebWidget::isModified() const
+{
+	return m_page->isModified();
+}
+
 bool QtWebKitWebWidget::isInspecting() const
 {
 	return (m_inspectorWidget && m_inspectorWidget->isVisible());
@@ -68,7 +68,6 @@ public:
 	QStringList getBlockedElements() const;
 	QUrl getUrl() const override;
 	QIcon getIcon() const override;
-	QPixmap createThumbnail(const QSize &size = {}) override;
 	QPoint getScrollPosition() const override;
 	QRect getGeometry(bool excludeScrollBars = false) const override;
 	LinkUrl getActiveFrame() const override;
@@ -93,6 +92,7 @@ public:
 	bool isAudible() const override;
 	bool isAudioMuted() const override;
 	bool isFullScreen() const override;
+	bool isModified() const override;
 	bool isPrivate() const override;
 	bool eventFilter(QObject *object, QEvent *event) override;
 
@@ -135,6 +135,7 @@ protected:
 	void setHistory(const QVariantMap &history);
 	void setOptions(const QHash<int, QVariant> &options, const QStringList &excludedOptions = {}) override;
 	QtWebKitPage* getPage() const;
+	QPixmap renderThumbnail(const QSize &size) override;
 	QString getMessageToken() const;
 	QString getPluginToken() const;
 	QUrl resolveUrl(QWebFrame *frame, const QUrl &url) const;
@@ -184,7 +185,6 @@ private:
 	QtWebKitNetworkManager *m_networkManager;
 	QString m_messageToken;
 	QString m_pluginToken;
-	QPixmap m_thumbnail;
 	QNetworkRequest m_formRequest;
 	QByteArray m_formRequestBody;
 	QQueue<Transfer*> m_transfers;
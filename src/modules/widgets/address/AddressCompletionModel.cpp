@@ -32,6 +32,8 @@
 #include <QtCore/QMimeDatabase>
 #include <QtWidgets/QFileIconProvider>
 
+#define HISTORY_COMPLETION_LIMIT 100
+
 namespace Otter
 {
 
@@ -154,7 +156,7 @@ void AddressCompletionModel::updateModel()
 
 	if (m_types.testFlag(HistoryCompletionType))
 	{
-		const QVector<HistoryModel::HistoryEntryMatch> entries(HistoryManager::findEntries(m_filter));
+		const QVector<HistoryModel::HistoryEntryMatch> entries(HistoryManager::findEntries(m_filter, false, HISTORY_COMPLETION_LIMIT));
 
 		if (m_showCompletionCategories && !entries.isEmpty())
 		{
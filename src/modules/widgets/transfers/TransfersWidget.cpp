@@ -220,6 +220,13 @@ TransferActionWidget::TransferActionWidget(Transfer *transfer, QWidget *parent)
 	connect(transfer, &Transfer::progressChanged, this, &TransferActionWidget::updateState);
 	connect(m_toolButton, &QToolButton::clicked, [&]()
 	{
+		if (m_transfer->isQueued())
+		{
+			m_transfer->stop();
+
+			return;
+		}
+
 		switch (m_transfer->getState())
 		{
 			case Transfer::CancelledState:
@@ -260,12 +267,16 @@ void TransferActionWidget::updateState()
 	QString details;
 	QVector<QPair<QString, QString> > detailsValues({{tr("From:"), Utils::extractHost(m_transfer->getSource())}});
 	const bool isIndeterminate(m_transfer->getBytesTotal() <= 0);
-	const bool hasError(m_transfer->getState() == Transfer::UnknownState || m_transfer->getState() == Transfer::ErrorState);
+	const bool hasError((m_transfer->getState() == Transfer::UnknownState || m_transfer->getState() == Transfer::ErrorState) && !m_transfer->isQueued());
 
 	if (m_transfer->getState() == Transfer::FinishedState)
 	{
 		detailsValues.append({tr("Size:"), tr("%1 (download completed)").arg(Utils::formatUnit(m_transfer->getBytesTotal()))});
 	}
+	else if (m_transfer->isQueued())
+	{
+		detailsValues.append({tr("Size:"), tr("%1 (queued)").arg(Utils::formatUnit(m_transfer->getBytesTotal()))});
+	}
 	else
 	{
 		detailsValues.append({tr("Size:"), tr("%1 (%2% downloaded)").arg(Utils::formatUnit(m_transfer->getBytesTotal())).arg(Utils::calculatePercent(m_transfer->getBytesReceived(), m_transfer->getBytesTotal()), 0, 'f', 1)});
@@ -289,6 +300,14 @@ void TransferActionWidget::updateState()
 	m_progressBar->setValue(isIndeterminate ? (hasError ? 0 : -1) : ((m_transfer->getBytesTotal() > 0) ? qFloor(Utils::calculatePercent(m_transfer->getBytesReceived(), m_transfer->getBytesTotal())) : -1));
 	m_progressBar->setFormat(isIndeterminate ? tr("Unknown") : QLatin1String("%p%"));
 
+	if (m_transfer->isQueued())
+	{
+		m_toolButton->setIcon(ThemesManager::createIcon(QLatin1String("task-reject")));
+		m_toolButton->setToolTip(tr("Stop"));
+
+		return;
+	}
+
 	switch (m_transfer->getState())
 	{
 		case Transfer::CancelledState:
@@ -117,7 +117,7 @@ void CacheContentsWidget::populateCache()
 	m_model->setHeaderData(2, Qt::Horizontal, 150, HeaderViewWidget::WidthRole);
 	m_model->setSortRole(Qt::DisplayRole);
 
-	const NetworkCache *cache(NetworkManagerFactory::getCache());
+	NetworkCache *cache(NetworkManagerFactory::getCache());
 	const QVector<QUrl> entries(cache->getEntries());
 
 	for (int i = 0; i < entries.count(); ++i)
@@ -250,42 +250,26 @@ void CacheContentsWidget::handleEntryAdded(const QUrl &entry)
 	}
 
 	NetworkCache *cache(NetworkManagerFactory::getCache());
-	QIODevice *device(cache->data(entry));
-	const QNetworkCacheMetaData metaData(cache->metaData(entry));
-	const QList<QPair<QByteArray, QByteArray> > headers(metaData.rawHeaders());
-	QString type;
-
-	for (int i = 0; i < headers.count(); ++i)
-	{
-		if (headers.at(i).first == QByteArrayLiteral("Content-Type"))
-		{
-			type = QString::fromLatin1(headers.at(i).second);
-
-			break;
-		}
-	}
-
-	const QMimeType mimeType((device && type.isEmpty()) ? QMimeDatabase().mimeTypeForData(device) : QMimeDatabase().mimeTypeForName(type));
-	QList<QStandardItem*> entryItems({new QStandardItem(entry.path()), new QStandardItem(mimeType.name()), new QStandardItem(device ? Utils::formatUnit(device->size()) : QString()), new QStandardItem(Utils::formatDateTime(metaData.lastModified())), new QStandardItem(Utils::formatDateTime(metaData.expirationDate()))});
+	const NetworkCache::EntryInformation information(cache->getEntry(entry));
+	const QString type(information.mimeType.isEmpty() ? cache->sniffMimeType(entry) : QMimeDatabase().mimeTypeForName(information.mimeType).name());
+	QList<QStandardItem*> entryItems({new QStandardItem(entry.path()), new QStandardItem(type), new QStandardItem((information.size >= 0) ? Utils::formatUnit(information.size) : QString()), new QStandardItem(Utils::formatDateTime(information.lastModified)), new QStandardItem(Utils::formatDateTime(information.expirationDate))});
 	entryItems[0]->setData(entry, Qt::UserRole);
 	entryItems[0]->setFlags(entryItems[0]->flags() | Qt::ItemNeverHasChildren);
 	entryItems[1]->setFlags(entryItems[1]->flags() | Qt::ItemNeverHasChildren);
-	entryItems[2]->setData((device ? device->size() : 0), Qt::UserRole);
+	entryItems[2]->setData(qMax(information.size, static_cast<qint64>(0)), Qt::UserRole);
 	entryItems[2]->setFlags(entryItems[2]->flags() | Qt::ItemNeverHasChildren);
 	entryItems[3]->setFlags(entryItems[3]->flags() | Qt::ItemNeverHasChildren);
 	entryItems[4]->setFlags(entryItems[4]->flags() | Qt::ItemNeverHasChildren);
 
-	if (device)
+	if (information.size > 0)
 	{
 		QStandardItem *sizeItem(m_model->item(domainItem->row(), 2));
 
 		if (sizeItem)
 		{
-			sizeItem->setData((sizeItem->data(Qt::UserRole).toLongLong() + device->size()), Qt::UserRole);
+			sizeItem->setData((sizeItem->data(Qt::UserRole).toLongLong() + information.size), Qt::UserRole);
 			sizeItem->setText(Utils::formatUnit(sizeItem->data(Qt::UserRole).toLongLong()));
 		}
-
-		device->deleteLater();
 	}
 
 	domainItem->appendRow(entryItems);
@@ -49,7 +49,7 @@ void ProgressBarDelegate::setEditorData(QWidget *editor, const QModelIndex &inde
 	{
 		const Transfer::TransferState state(static_cast<Transfer::TransferState>(index.data(TransfersContentsWidget::StateRole).toInt()));
 		const bool isIndeterminate(index.data(TransfersContentsWidget::BytesTotalRole).toLongLong() <= 0);
-		const bool hasError(state == Transfer::UnknownState || state == Transfer::ErrorState);
+		const bool hasError((state == Transfer::UnknownState || state == Transfer::ErrorState) && !index.data(TransfersContentsWidget::IsQueuedRole).toBool());
 
 		progressBar->setHasError(hasError);
 		progressBar->setRange(0, ((isIndeterminate && !hasError) ? 0 : 100));
@@ -202,6 +202,15 @@ void TransfersContentsWidget::stopResumeTransfer()
 
 	if (transfer)
 	{
+		if (transfer->isQueued())
+		{
+			transfer->stop();
+
+			updateActions();
+
+			return;
+		}
+
 		switch (transfer->getState())
 		{
 			case Transfer::RunningState:
@@ -279,6 +288,11 @@ void TransfersContentsWidget::handleTransferChanged(Transfer *transfer)
 			break;
 	}
 
+	if (transfer->isQueued())
+	{
+		iconName = QLatin1String("task-ongoing");
+	}
+
 	const QString toolTip(tr("<div style=\"white-space:pre;\">Source: %1\nTarget: %2\nSize: %3\nDownloaded: %4\nProgress: %5</div>").arg(transfer->getSource().toDisplayString().toHtmlEscaped(), transfer->getTarget().toHtmlEscaped(), (isIndeterminate ? tr("Unknown") : Utils::formatUnit(transfer->getBytesTotal(), false, 1, true)), Utils::formatUnit(transfer->getBytesReceived(), false, 1, true), (isIndeterminate ? tr("Unknown") : QStringLiteral("%1%").arg(Utils::calculatePercent(transfer->getBytesReceived(), transfer->getBytesTotal()), 0, 'f', 1))));
 
 	for (int i = 0; i < m_model->columnCount(); ++i)
@@ -308,6 +322,7 @@ void TransfersContentsWidget::handleTransferChanged(Transfer *transfer)
 				m_model->setData(index, transfer->getBytesTotal(), BytesTotalRole);
 				m_model->setData(index, ((transfer->getBytesTotal() > 0) ? qFloor(Utils::calculatePercent(transfer->getBytesReceived(), transfer->getBytesTotal())) : -1), ProgressRole);
 				m_model->setData(index, transfer->getState(), StateRole);
+				m_model->setData(index, transfer->isQueued(), IsQueuedRole);
 
 				break;
 			case 4:
@@ -315,7 +330,14 @@ void TransfersContentsWidget::handleTransferChanged(Transfer *transfer)
 
 				break;
 			case 5:
-				m_model->setData(index, ((transfer->getState() == Transfer::RunningState) ? Utils::formatUnit(transfer->getSpeed(), true, 1) : QString()), Qt::DisplayRole);
+				if (transfer->isQueued())
+				{
+					m_model->setData(index, tr("Queued"), Qt::DisplayRole);
+				}
+				else
+				{
+					m_model->setData(index, ((transfer->getState() == Transfer::RunningState) ? Utils::formatUnit(transfer->getSpeed(), true, 1) : QString()), Qt::DisplayRole);
+				}
 
 				break;
 			case 6:
@@ -359,7 +381,7 @@ void TransfersContentsWidget::handleTransferChanged(Transfer *transfer)
 
 void TransfersContentsWidget::showContextMenu(const QPoint &position)
 {
-	const Transfer *transfer(getTransfer(m_ui->transfersViewWidget->indexAt(position)));
+	Transfer *transfer(getTransfer(m_ui->transfersViewWidget->indexAt(position)));
 	QMenu menu(this);
 
 	if (transfer)
@@ -377,8 +399,48 @@ void TransfersContentsWidget::showContextMenu(const QPoint &position)
 		menu.addMenu(openWithMenu);
 		menu.addAction(tr("Open Folder"), this, &TransfersContentsWidget::openTransferFolder)->setEnabled(canOpen || QFileInfo(transfer->getTarget()).dir().exists());
 		menu.addSeparator();
-		menu.addAction(((transfer->getState() == Transfer::ErrorState) ? tr("Resume") : tr("Stop")), this, &TransfersContentsWidget::stopResumeTransfer)->setEnabled(transfer->getState() == Transfer::RunningState || transfer->getState() == Transfer::ErrorState);
+		menu.addAction(((transfer->getState() == Transfer::ErrorState && !transfer->isQueued()) ? tr("Resume") : tr("Stop")), this, &TransfersContentsWidget::stopResumeTransfer)->setEnabled(transfer->getState() == Transfer::RunningState || transfer->getState() == Transfer::ErrorState);
 		menu.addAction(tr("Redownload"), this, &TransfersContentsWidget::redownloadTransfer);
+		menu.addSeparator();
+
+		const bool canSchedule(transfer->getState() == Transfer::RunningState || transfer->getState() == Transfer::ErrorState);
+		QMenu *priorityMenu(menu.addMenu(tr("Priority")));
+		priorityMenu->setEnabled(canSchedule);
+
+		const QVector<QPair<Transfer::TransferPriority, QString> > priorities({{Transfer::HighPriority, tr("High")}, {Transfer::NormalPriority, tr("Normal")}, {Transfer::LowPriority, tr("Low")}});
+
+		for (int i = 0; i < priorities.count(); ++i)
+		{
+			const Transfer::TransferPriority priority(priorities.at(i).first);
+			QAction *action(priorityMenu->addAction(priorities.at(i).second, this, [=]()
+			{
+				transfer->setPriority(priority);
+			}));
+			action->setCheckable(true);
+			action->setChecked(transfer->getPriority() == priority);
+		}
+
+		QMenu *speedLimitMenu(menu.addMenu(tr("Speed Limit")));
+		speedLimitMenu->setEnabled(canSchedule);
+
+		const QVector<qint64> speedLimits({0, 65536, 262144, 1048576, 4194304});
+
+		for (int i = 0; i < speedLimits.count(); ++i)
+		{
+			const qint64 speedLimit(speedLimits.at(i));
+			QAction *action(speedLimitMenu->addAction(((speedLimit > 0) ? Utils::formatUnit(speedLimit, true, 0) : tr("Unlimited")), this, [=]()
+			{
+				transfer->setSpeedLimit(speedLimit);
+			}));
+			action->setCheckable(true);
+			action->setChecked(transfer->getSpeedLimit() == speedLimit);
+
+			if (i == 0)
+			{
+				speedLimitMenu->addSeparator();
+			}
+		}
+
 		menu.addSeparator();
 		menu.addAction(tr("Copy Transfer Information"), this, &TransfersContentsWidget::copyTransferInformation);
 		menu.addSeparator();
@@ -408,7 +470,7 @@ void TransfersContentsWidget::updateActions()
 {
 	const Transfer *transfer(getTransfer(m_ui->transfersViewWidget->getCurrentIndex()));
 
-	if (transfer && transfer->getState() == Transfer::ErrorState)
+	if (transfer && transfer->getState() == Transfer::ErrorState && !transfer->isQueued())
 	{
 		m_ui->stopResumeButton->setText(tr("Resume"));
 		m_ui->stopResumeButton->setIcon(ThemesManager::createIcon(QLatin1String("task-ongoing")));
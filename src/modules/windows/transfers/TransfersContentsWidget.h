@@ -55,6 +55,7 @@ public:
 		BytesReceivedRole = Qt::UserRole,
 		BytesTotalRole,
 		InstanceRole,
+		IsQueuedRole,
 		ProgressRole,
 		StateRole,
 		TimeFinishedRole,
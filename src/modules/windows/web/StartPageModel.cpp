@@ -24,18 +24,23 @@
 #include "../../../core/SettingsManager.h"
 #include "../../../core/WebBackend.h"
 
+#include <QtConcurrent/QtConcurrentRun>
 #include <QtCore/QDir>
 #include <QtCore/QFile>
 #include <QtCore/QMimeData>
 #include <QtCore/QTimer>
 #include <QtGui/QPainter>
 
+#define THUMBNAILS_CACHE_LIMIT 20480
+
 namespace Otter
 {
 
 StartPageModel::StartPageModel(QObject *parent) : QStandardItemModel(parent),
 	m_bookmark(nullptr)
 {
+	m_thumbnails.setMaxCost(THUMBNAILS_CACHE_LIMIT);
+
 	handleOptionChanged(SettingsManager::Backends_WebOption);
 	reloadModel();
 
@@ -162,12 +167,7 @@ void StartPageModel::handleBookmarkMoved(BookmarksModel::Bookmark *bookmark, Boo
 	{
 		if (bookmark->parent() != m_bookmark)
 		{
-			const QString path(getThumbnailPath(bookmark->getIdentifier()));
-
-			if (QFile::exists(path))
-			{
-				QFile::remove(path);
-			}
+			removeThumbnail(bookmark->getIdentifier());
 		}
 
 		if (bookmark == m_bookmark || previousParent == m_bookmark || m_bookmark->isAncestorOf(bookmark) || m_bookmark->isAncestorOf(previousParent))
@@ -181,12 +181,7 @@ void StartPageModel::handleBookmarkRemoved(BookmarksModel::Bookmark *bookmark, B
 {
 	if (m_bookmark && (bookmark == m_bookmark || previousParent == m_bookmark || m_bookmark->isAncestorOf(previousParent)))
 	{
-		const QString path(getThumbnailPath(bookmark->getIdentifier()));
-
-		if (QFile::exists(path))
-		{
-			QFile::remove(path);
-		}
+		removeThumbnail(bookmark->getIdentifier());
 
 		QTimer::singleShot(100, this, &StartPageModel::reloadModel);
 	}
@@ -208,7 +203,10 @@ void StartPageModel::handleThumbnailCreated(quint64 identifier, const QPixmap &t
 	{
 		QDir().mkpath(SessionsManager::getWritableDataPath(QLatin1String("thumbnails/")));
 
-		thumbnail.save(getThumbnailPath(identifier), "png");
+		if (thumbnail.save(getThumbnailPath(identifier), "png"))
+		{
+			updateThumbnail(identifier, thumbnail);
+		}
 	}
 
 	if (bookmark)
@@ -222,6 +220,66 @@ void StartPageModel::handleThumbnailCreated(quint64 identifier, const QPixmap &t
 	}
 }
 
+void StartPageModel::loadThumbnail(quint64 identifier)
+{
+	if (m_thumbnailWatchers.contains(identifier))
+	{
+		return;
+	}
+
+	const QString path(getThumbnailPath(identifier));
+	QFutureWatcher<QImage> *watcher(new QFutureWatcher<QImage>(this));
+
+	m_thumbnailWatchers[identifier] = watcher;
+
+	connect(watcher, &QFutureWatcher<QImage>::finished, this, [=]()
+	{
+		const QImage image(watcher->result());
+
+		watcher->deleteLater();
+
+		if (m_thumbnailWatchers.value(identifier) != watcher)
+		{
+			return;
+		}
+
+		m_thumbnailWatchers.remove(identifier);
+
+		updateThumbnail(identifier, QPixmap::fromImage(image));
+
+		BookmarksModel::Bookmark *bookmark(BookmarksManager::getModel()->getBookmark(identifier));
+
+		if (bookmark && bookmark->parent() == m_bookmark)
+		{
+			emit thumbnailChanged(index(bookmark->index().row(), bookmark->index().column()));
+		}
+	});
+
+	watcher->setFuture(QtConcurrent::run([=]() -> QImage
+	{
+		return QImage(path);
+	}));
+}
+
+void StartPageModel::updateThumbnail(quint64 identifier, const QPixmap &thumbnail)
+{
+	m_thumbnailWatchers.remove(identifier);
+	m_thumbnails.insert(identifier, new QPixmap(thumbnail), qMax(1, ((thumbnail.width() * thumbnail.height() * thumbnail.depth()) / 8192)));
+}
+
+void StartPageModel::removeThumbnail(quint64 identifier)
+{
+	const QString path(getThumbnailPath(identifier));
+
+	if (QFile::exists(path))
+	{
+		QFile::remove(path);
+	}
+
+	m_thumbnailWatchers.remove(identifier);
+	m_thumbnails.remove(identifier);
+}
+
 QMimeData* StartPageModel::mimeData(const QModelIndexList &indexes) const
 {
 	QMimeData *mimeData(new QMimeData());
@@ -267,6 +325,20 @@ QString StartPageModel::getThumbnailPath(quint64 identifier)
 	return SessionsManager::getWritableDataPath(QLatin1String("thumbnails/")) + QString::number(identifier) + QLatin1String(".png");
 }
 
+QPixmap StartPageModel::getThumbnail(quint64 identifier)
+{
+	const QPixmap *thumbnail(m_thumbnails.object(identifier));
+
+	if (thumbnail)
+	{
+		return *thumbnail;
+	}
+
+	loadThumbnail(identifier);
+
+	return {};
+}
+
 QVariant StartPageModel::data(const QModelIndex &index, int role) const
 {
 	if (role == IsReloadingRole)
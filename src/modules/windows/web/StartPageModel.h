@@ -22,6 +22,10 @@
 
 #include "../../../core/BookmarksModel.h"
 
+#include <QtCore/QCache>
+#include <QtCore/QFutureWatcher>
+#include <QtGui/QPixmap>
+
 namespace Otter
 {
 
@@ -42,6 +46,7 @@ public:
 	QMimeData* mimeData(const QModelIndexList &indexes) const override;
 	static BookmarksModel::Bookmark* getBookmark(const QModelIndex &index);
 	static QString getThumbnailPath(quint64 identifier);
+	QPixmap getThumbnail(quint64 identifier);
 	QVariant data(const QModelIndex &index, int role) const override;
 	QStringList mimeTypes() const override;
 	bool reloadTile(const QModelIndex &index, bool needsTitleUpdate = false);
@@ -53,6 +58,9 @@ public slots:
 	QModelIndex addTile(const QUrl &url);
 
 protected:
+	void loadThumbnail(quint64 identifier);
+	void updateThumbnail(quint64 identifier, const QPixmap &thumbnail);
+	void removeThumbnail(quint64 identifier);
 	bool requestThumbnail(const QUrl &url, quint64 identifier, bool needsTitleUpdate = false);
 
 protected slots:
@@ -65,11 +73,14 @@ protected slots:
 
 private:
 	BookmarksModel::Bookmark *m_bookmark;
+	QCache<quint64, QPixmap> m_thumbnails;
 	QHash<quint64, bool> m_reloads;
+	QHash<quint64, QFutureWatcher<QImage>*> m_thumbnailWatchers;
 
 signals:
 	void modelModified();
 	void isReloadingTileChanged(const QModelIndex &index);
+	void thumbnailChanged(const QModelIndex &index);
 };
 
 }
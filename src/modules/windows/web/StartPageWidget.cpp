@@ -177,12 +177,21 @@ void TileDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option,
 
 				break;
 			case ThumbnailBackground:
-				pixmapPainter.save();
-				pixmapPainter.setBrush(Qt::white);
-				pixmapPainter.setPen(Qt::transparent);
-				pixmapPainter.drawRect(rectangle);
-				pixmapPainter.drawPixmap(rectangle, QPixmap(StartPageModel::getThumbnailPath(identifier)), rectangle.translated(-rectangle.topLeft()));
-				pixmapPainter.restore();
+				{
+					StartPageModel *model(qobject_cast<StartPageModel*>(static_cast<QAbstractItemView*>(m_widget)->model()));
+
+					pixmapPainter.save();
+					pixmapPainter.setBrush(Qt::white);
+					pixmapPainter.setPen(Qt::transparent);
+					pixmapPainter.drawRect(rectangle);
+
+					if (model)
+					{
+						pixmapPainter.drawPixmap(rectangle, model->getThumbnail(identifier), rectangle.translated(-rectangle.topLeft()));
+					}
+
+					pixmapPainter.restore();
+				}
 
 				break;
 			default:
@@ -534,6 +543,7 @@ StartPageWidget::StartPageWidget(Window *parent) : QScrollArea(parent),
 
 	connect(m_model, &StartPageModel::modelModified, this, &StartPageWidget::updateSize);
 	connect(m_model, &StartPageModel::isReloadingTileChanged, this, &StartPageWidget::handleIsReloadingTileChanged);
+	connect(m_model, &StartPageModel::thumbnailChanged, this, &StartPageWidget::handleThumbnailChanged);
 	connect(SettingsManager::getInstance(), &SettingsManager::optionChanged, this, &StartPageWidget::handleOptionChanged);
 }
 
@@ -1022,6 +1032,13 @@ void StartPageWidget::handleIsReloadingTileChanged(const QModelIndex &index)
 	}
 }
 
+void StartPageWidget::handleThumbnailChanged(const QModelIndex &index)
+{
+	QPixmapCache::remove(m_tileDelegate->createPixmapCacheKey(m_listView->visualRect(index), index.data(BookmarksModel::IdentifierRole).toULongLong()));
+
+	m_listView->update(index);
+}
+
 void StartPageWidget::updateSize()
 {
 	const qreal zoom(SettingsManager::getOption(SettingsManager::StartPage_ZoomLevelOption).toInt() / static_cast<qreal>(100));
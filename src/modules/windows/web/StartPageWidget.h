@@ -137,6 +137,7 @@ protected slots:
 	void removeTile();
 	void handleOptionChanged(int identifier, const QVariant &value);
 	void handleIsReloadingTileChanged(const QModelIndex &index);
+	void handleThumbnailChanged(const QModelIndex &index);
 	void updateSize();
 	void showContextMenu(const QPoint &position = {});
 
@@ -1207,6 +1207,7 @@ void WebContentsWidget::setWidget(WebWidget *widget, const QVariantMap &paramete
 	connect(m_webWidget, &WebWidget::urlChanged, this, &WebContentsWidget::urlChanged);
 	connect(m_webWidget, &WebWidget::urlChanged, this, &WebContentsWidget::handleUrlChange);
 	connect(m_webWidget, &WebWidget::iconChanged, this, &WebContentsWidget::iconChanged);
+	connect(m_webWidget, &WebWidget::thumbnailChanged, this, &WebContentsWidget::thumbnailChanged);
 	connect(m_webWidget, &WebWidget::requestBlocked, this, &WebContentsWidget::requestBlocked);
 	connect(m_webWidget, &WebWidget::arbitraryActionsStateChanged, this, &WebContentsWidget::arbitraryActionsStateChanged);
 	connect(m_webWidget, &WebWidget::categorizedActionsStateChanged, this, &WebContentsWidget::categorizedActionsStateChanged);
@@ -102,6 +102,7 @@ signals:
 	void titleChanged(const QString &title);
 	void urlChanged(const QUrl &url);
 	void iconChanged(const QIcon &icon);
+	void thumbnailChanged();
 	void requestBlocked(const NetworkManager::ResourceInformation &request);
 	void arbitraryActionsStateChanged(const QVector<int> &identifiers);
 	void categorizedActionsStateChanged(const QVector<int> &categories);
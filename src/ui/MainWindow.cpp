@@ -39,11 +39,13 @@
 #include "../core/ActionsManager.h"
 #include "../core/Application.h"
 #include "../core/BookmarksManager.h"
+#include "../core/Console.h"
 #include "../core/FeedsManager.h"
 #include "../core/InputInterpreter.h"
 #include "../core/ItemModel.h"
 #include "../core/SessionModel.h"
 #include "../core/SettingsManager.h"
+#include "../core/TabSuspensionManager.h"
 #include "../core/ThemesManager.h"
 #include "../core/TransfersManager.h"
 #include "../core/Utils.h"
@@ -1242,6 +1244,8 @@ void MainWindow::search(const QString &query, const QString &searchEngine, Sessi
 
 void MainWindow::restoreSession(const Session::MainWindow &session)
 {
+	m_sessionRestoreTimer.start();
+
 	int index(session.index);
 
 	if (index >= session.windows.count())
@@ -1293,6 +1297,52 @@ void MainWindow::restoreSession(const Session::MainWindow &session)
 
 	m_workspace->markAsRestored();
 
+	if (m_activeWindow && !m_activeWindow->isSuspended())
+	{
+		disconnect(m_sessionRestoreConnection);
+
+		m_sessionRestoreConnection = connect(m_activeWindow, &Window::loadingStateChanged, this, [&](WebWidget::LoadingState state)
+		{
+			if (state != WebWidget::OngoingLoadingState)
+			{
+				disconnect(m_sessionRestoreConnection);
+
+				if (state == WebWidget::FinishedLoadingState && m_sessionRestoreTimer.isValid())
+				{
+					Console::addMessage(QCoreApplication::translate("main", "Session restored, active tab loaded after %1 ms").arg(m_sessionRestoreTimer.elapsed()), Console::OtherCategory, Console::LogLevel);
+				}
+
+				m_sessionRestoreTimer.invalidate();
+			}
+		});
+
+		const int prewarmAmount(SettingsManager::getOption(SettingsManager::Sessions_PrewarmTabsAmountOption).toInt());
+		const int activeIndex(getWindowIndex(m_activeWindow->getIdentifier()));
+		QVector<Window*> windows;
+
+		for (int i = 1; (i < m_windows.count() && windows.count() < prewarmAmount); ++i)
+		{
+			Window *nextWindow(getWindowByIndex(activeIndex + i));
+			Window *previousWindow(getWindowByIndex(activeIndex - i));
+
+			if (nextWindow && nextWindow->isSuspended())
+			{
+				windows.append(nextWindow);
+			}
+
+			if (previousWindow && previousWindow->isSuspended() && windows.count() < prewarmAmount)
+			{
+				windows.append(previousWindow);
+			}
+		}
+
+		TabSuspensionManager::prewarmWindows(windows);
+	}
+	else
+	{
+		m_sessionRestoreTimer.invalidate();
+	}
+
 	emit sessionRestored();
 }
 
@@ -26,6 +26,7 @@
 #include "../core/GesturesController.h"
 #include "../core/SessionsManager.h"
 
+#include <QtCore/QElapsedTimer>
 #include <QtWidgets/QMainWindow>
 #include <QtWidgets/QShortcut>
 
@@ -146,6 +147,8 @@ private:
 	QMap<QString, QVector<int> > m_splitters;
 	QMap<int, ToolBarWidget*> m_toolBars;
 	QMap<int, Session::MainWindow::ToolBarState> m_toolBarStates;
+	QElapsedTimer m_sessionRestoreTimer;
+	QMetaObject::Connection m_sessionRestoreConnection;
 	Qt::WindowStates m_previousState;
 	Qt::WindowStates m_previousRaisedState;
 	quint64 m_identifier;
@@ -30,6 +30,7 @@
 #include "../core/Application.h"
 #include "../core/InputInterpreter.h"
 #include "../core/SettingsManager.h"
+#include "../core/TabSuspensionManager.h"
 #include "../core/ThemesManager.h"
 
 #include <QtCore/QMimeData>
@@ -47,6 +48,8 @@
 #include <QtWidgets/QStylePainter>
 #include <QtWidgets/QToolTip>
 
+#define SUSPENDED_TAB_RESTORE_DELAY 300
+
 namespace Otter
 {
 
@@ -72,6 +75,7 @@ TabHandleWidget::TabHandleWidget(Window *window, TabBarWidget *parent) : QWidget
 	connect(window, &Window::needsAttention, this, &TabHandleWidget::markAsNeedingAttention);
 	connect(window, &Window::titleChanged, this, &TabHandleWidget::updateTitle);
 	connect(window, &Window::iconChanged, this, static_cast<void(TabHandleWidget::*)()>(&TabHandleWidget::update));
+	connect(window, &Window::thumbnailChanged, this, static_cast<void(TabHandleWidget::*)()>(&TabHandleWidget::update));
 	connect(window, &Window::loadingStateChanged, this, &TabHandleWidget::handleLoadingStateChanged);
 	connect(parent, &TabBarWidget::currentChanged, this, &TabHandleWidget::updateGeometries);
 	connect(parent, &TabBarWidget::tabsAmountChanged, this, &TabHandleWidget::updateGeometries);
@@ -583,6 +587,7 @@ TabBarWidget::TabBarWidget(QWidget *parent) : QTabBar(parent),
 	m_hoveredTab(-1),
 	m_pinnedTabsAmount(0),
 	m_previewTimer(0),
+	m_restoreTimer(0),
 	m_arePreviewsEnabled(SettingsManager::getOption(SettingsManager::TabBar_EnablePreviewsOption).toBool()),
 	m_isDraggingTab(false),
 	m_isDetachingTab(false),
@@ -668,6 +673,14 @@ void TabBarWidget::timerEvent(QTimerEvent *event)
 
 		showPreview(tabAt(mapFromGlobal(QCursor::pos())));
 	}
+	else if (event->timerId() == m_restoreTimer)
+	{
+		killTimer(m_restoreTimer);
+
+		m_restoreTimer = 0;
+
+		TabSuspensionManager::restoreWindow(getWindow(m_hoveredTab));
+	}
 }
 
 void TabBarWidget::paintEvent(QPaintEvent *event)
@@ -1183,6 +1196,20 @@ void TabBarWidget::tabHovered(int index)
 
 	m_hoveredTab = index;
 
+	if (m_restoreTimer != 0)
+	{
+		killTimer(m_restoreTimer);
+
+		m_restoreTimer = 0;
+	}
+
+	const Window *window(getWindow(index));
+
+	if (window && window->isSuspended())
+	{
+		m_restoreTimer = startTimer(SUSPENDED_TAB_RESTORE_DELAY);
+	}
+
 	if (m_previewWidget && !m_previewWidget->isVisible() && m_previewTimer == 0)
 	{
 		m_previewWidget->show();
@@ -1193,16 +1220,11 @@ void TabBarWidget::tabHovered(int index)
 		showPreview(index);
 	}
 
-	if (!m_isDraggingTab)
+	if (!m_isDraggingTab && window)
 	{
-		const Window *window(getWindow(index));
+		QStatusTipEvent statusTipEvent(window->getUrl().toDisplayString());
 
-		if (window)
-		{
-			QStatusTipEvent statusTipEvent(window->getUrl().toDisplayString());
-
-			QApplication::sendEvent(this, &statusTipEvent);
-		}
+		QApplication::sendEvent(this, &statusTipEvent);
 	}
 }
 
@@ -1222,6 +1244,7 @@ void TabBarWidget::addTab(int index, Window *window)
 	}
 
 	connect(window, &Window::isPinnedChanged, this, &TabBarWidget::updatePinnedTabsAmount);
+	connect(window, &Window::thumbnailChanged, this, &TabBarWidget::handleThumbnailChanged);
 
 	if (window->isPinned())
 	{
@@ -1521,6 +1544,21 @@ void TabBarWidget::handleCurrentChanged(int index)
 	m_activeTabHandleWidget = tabHandleWidget;
 }
 
+void TabBarWidget::handleThumbnailChanged()
+{
+	if (!m_previewWidget || !m_previewWidget->isVisible() || m_areThumbnailsEnabled)
+	{
+		return;
+	}
+
+	const int index(tabAt(mapFromGlobal(QCursor::pos())));
+
+	if (index >= 0 && index != currentIndex() && getWindow(index) == sender())
+	{
+		showPreview(index);
+	}
+}
+
 void TabBarWidget::updatePinnedTabsAmount()
 {
 	int amount(0);
@@ -130,6 +130,7 @@ protected:
 protected slots:
 	void handleOptionChanged(int identifier, const QVariant &value);
 	void handleCurrentChanged(int index);
+	void handleThumbnailChanged();
 	void updatePinnedTabsAmount();
 	void updateStyle();
 	void setArea(Qt::ToolBarArea area);
@@ -148,6 +149,7 @@ private:
 	int m_hoveredTab;
 	int m_pinnedTabsAmount;
 	int m_previewTimer;
+	int m_restoreTimer;
 	bool m_arePreviewsEnabled;
 	bool m_isDraggingTab;
 	bool m_isDetachingTab;
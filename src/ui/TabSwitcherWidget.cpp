@@ -309,6 +309,16 @@ void TabSwitcherWidget::setLoadingState(WebWidget::LoadingState state)
 	}
 }
 
+void TabSwitcherWidget::updatePreview()
+{
+	Window *window(qobject_cast<Window*>(sender()));
+
+	if (window && isVisible() && window->getIdentifier() == m_tabsView->currentIndex().data(IdentifierRole).toULongLong() && window->getLoadingState() == WebWidget::FinishedLoadingState)
+	{
+		m_previewLabel->setPixmap(window->createThumbnail());
+	}
+}
+
 QStandardItem* TabSwitcherWidget::createRow(Window *window, const QVariant &index) const
 {
 	QColor color(palette().color(QPalette::Text));
@@ -327,6 +337,7 @@ QStandardItem* TabSwitcherWidget::createRow(Window *window, const QVariant &inde
 	connect(window, &Window::titleChanged, this, &TabSwitcherWidget::setTitle);
 	connect(window, &Window::iconChanged, this, &TabSwitcherWidget::setIcon);
 	connect(window, &Window::loadingStateChanged, this, &TabSwitcherWidget::setLoadingState);
+	connect(window, &Window::thumbnailChanged, this, &TabSwitcherWidget::updatePreview);
 
 	return item;
 }
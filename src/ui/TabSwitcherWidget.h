@@ -73,6 +73,7 @@ protected slots:
 	void setTitle(const QString &title);
 	void setIcon(const QIcon &icon);
 	void setLoadingState(WebWidget::LoadingState state);
+	void updatePreview();
 
 private:
 	MainWindow *m_mainWindow;
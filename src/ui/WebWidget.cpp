@@ -42,9 +42,14 @@
 #include <QtCore/QDir>
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonDocument>
+#include <QtCore/QtMath>
 #include <QtGui/QClipboard>
 #include <QtWidgets/QToolTip>
 
+#define THUMBNAIL_IDLE_DELAY 250
+#define THUMBNAIL_SIZE_STEP 32
+#define THUMBNAIL_UPDATE_INTERVAL 2000
+
 namespace Otter
 {
 
@@ -57,6 +62,7 @@ WebWidget::WebWidget(const QVariantMap &parameters, WebBackend *backend, Content
 	m_loadingTime(0),
 	m_loadingTimer(0),
 	m_reloadTimer(0),
+	m_thumbnailTimer(0),
 	m_toolTipEntryEnumerator(metaObject()->indexOfEnumerator(QLatin1String("ToolTipEntry").data()))
 {
 	Q_UNUSED(parameters)
@@ -91,6 +97,14 @@ void WebWidget::timerEvent(QTimerEvent *event)
 			triggerAction(ActionsManager::ReloadAction);
 		}
 	}
+	else if (event->timerId() == m_thumbnailTimer)
+	{
+		killTimer(m_thumbnailTimer);
+
+		m_thumbnailTimer = 0;
+
+		updateThumbnails();
+	}
 }
 
 void WebWidget::triggerAction(int identifier, const QVariantMap &parameters, ActionsManager::TriggerType trigger)
@@ -278,6 +292,60 @@ void WebWidget::handleLoadingStateChange(LoadingState state)
 
 		emit pageInformationChanged(LoadingTimeInformation, 0);
 	}
+	else if (state == FinishedLoadingState && !m_thumbnailSizes.isEmpty())
+	{
+		QHash<quint64, QSize>::const_iterator iterator;
+
+		for (iterator = m_thumbnailSizes.constBegin(); iterator != m_thumbnailSizes.constEnd(); ++iterator)
+		{
+			m_outdatedThumbnails.insert(iterator.key());
+		}
+
+		scheduleThumbnailUpdate();
+	}
+}
+
+void WebWidget::scheduleThumbnailUpdate()
+{
+	if (m_thumbnailTimer != 0 || m_outdatedThumbnails.isEmpty() || getLoadingState() == OngoingLoadingState)
+	{
+		return;
+	}
+
+	const qint64 elapsed(m_thumbnailUpdateTimer.isValid() ? m_thumbnailUpdateTimer.elapsed() : THUMBNAIL_UPDATE_INTERVAL);
+
+	m_thumbnailTimer = startTimer(static_cast<int>(qMax(static_cast<qint64>(THUMBNAIL_IDLE_DELAY), (THUMBNAIL_UPDATE_INTERVAL - elapsed))));
+}
+
+void WebWidget::updateThumbnails()
+{
+	if (m_outdatedThumbnails.isEmpty() || getLoadingState() == OngoingLoadingState)
+	{
+		return;
+	}
+
+	QSet<quint64>::const_iterator iterator;
+	bool hasChanges(false);
+
+	for (iterator = m_outdatedThumbnails.constBegin(); iterator != m_outdatedThumbnails.constEnd(); ++iterator)
+	{
+		const QPixmap thumbnail(renderThumbnail(m_thumbnailSizes.value(*iterator)));
+
+		if (!thumbnail.isNull())
+		{
+			m_thumbnails[*iterator] = thumbnail;
+
+			hasChanges = true;
+		}
+	}
+
+	m_outdatedThumbnails.clear();
+	m_thumbnailUpdateTimer.start();
+
+	if (hasChanges)
+	{
+		emit thumbnailChanged();
+	}
 }
 
 void WebWidget::handleToolTipEvent(QHelpEvent *event, QWidget *widget)
@@ -994,9 +1062,31 @@ QUrl WebWidget::getRequestedUrl() const
 
 QPixmap WebWidget::createThumbnail(const QSize &size)
 {
-	Q_UNUSED(size)
+	const QSize thumbnailSize(size.isValid() ? size : QSize(260, 170));
+	const quint64 key((static_cast<quint64>(qCeil(thumbnailSize.width() / static_cast<qreal>(THUMBNAIL_SIZE_STEP))) << 32) | static_cast<quint64>(qCeil(thumbnailSize.height() / static_cast<qreal>(THUMBNAIL_SIZE_STEP))));
+	const QPixmap thumbnail(m_thumbnails.value(key));
 
-	return {};
+	if (!m_thumbnailSizes.contains(key))
+	{
+		m_thumbnailSizes[key] = thumbnailSize;
+	}
+
+	if (thumbnail.isNull() || !qFuzzyCompare(thumbnail.devicePixelRatio(), devicePixelRatio()))
+	{
+		m_outdatedThumbnails.insert(key);
+
+		scheduleThumbnailUpdate();
+	}
+
+	if (thumbnail.isNull() || thumbnail.size() == (thumbnailSize * thumbnail.devicePixelRatio()))
+	{
+		return thumbnail;
+	}
+
+	QPixmap pixmap(thumbnail.scaled((thumbnailSize * thumbnail.devicePixelRatio()), Qt::KeepAspectRatio, Qt::SmoothTransformation));
+	pixmap.setDevicePixelRatio(thumbnail.devicePixelRatio());
+
+	return pixmap;
 }
 
 QPoint WebWidget::getClickPosition() const
@@ -1522,6 +1612,13 @@ QMultiMap<QString, QString> WebWidget::getMetaData() const
 	return {};
 }
 
+QPixmap WebWidget::renderThumbnail(const QSize &size)
+{
+	Q_UNUSED(size)
+
+	return {};
+}
+
 WebWidget::HitTestResult WebWidget::getCurrentHitTestResult() const
 {
 	return m_hitResult;
@@ -1774,6 +1871,11 @@ bool WebWidget::isFullScreen() const
 	return false;
 }
 
+bool WebWidget::isModified() const
+{
+	return false;
+}
+
 bool WebWidget::isWatchingChanges(ChangeWatcher watcher) const
 {
 	return m_changeWatchers.contains(watcher);
@@ -29,6 +29,8 @@
 #include "../core/SessionsManager.h"
 #include "../core/SpellCheckManager.h"
 
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QSet>
 #include <QtGui/QHelpEvent>
 #include <QtNetwork/QSslCertificate>
 #include <QtNetwork/QSslCipher>
@@ -229,7 +231,7 @@ public:
 	virtual QUrl getUrl() const = 0;
 	QUrl getRequestedUrl() const;
 	virtual QIcon getIcon() const = 0;
-	virtual QPixmap createThumbnail(const QSize &size = {});
+	QPixmap createThumbnail(const QSize &size = {});
 	QPoint getClickPosition() const;
 	virtual QPoint getScrollPosition() const = 0;
 	virtual QRect getGeometry(bool excludeScrollBars = false) const;
@@ -260,6 +262,7 @@ public:
 	virtual bool isAudible() const;
 	virtual bool isAudioMuted() const;
 	virtual bool isFullScreen() const;
+	virtual bool isModified() const;
 	virtual bool isPrivate() const = 0;
 	bool isWatchingChanges(ChangeWatcher watcher) const;
 
@@ -284,6 +287,8 @@ protected:
 	void timerEvent(QTimerEvent *event) override;
 	void openUrl(const QUrl &url, SessionsManager::OpenHints hints);
 	void startReloadTimer();
+	void scheduleThumbnailUpdate();
+	void updateThumbnails();
 	void startTransfer(Transfer *transfer);
 	void handleToolTipEvent(QHelpEvent *event, QWidget *widget);
 	void updateHitTestResult(const QPoint &position);
@@ -294,6 +299,7 @@ protected:
 	QString getSavePath(const QVector<SaveFormat> &allowedFormats, SaveFormat *selectedFormat) const;
 	QString getOpenActionText(SessionsManager::OpenHints hints) const;
 	static QString getFastForwardScript(bool isSelectingTheBestLink);
+	virtual QPixmap renderThumbnail(const QSize &size);
 	HitTestResult getCurrentHitTestResult() const;
 	PermissionPolicy getPermission(FeaturePermission feature, const QUrl &url) const;
 	static SessionsManager::OpenHints mapOpenActionToOpenHints(int identifier);
@@ -328,11 +334,16 @@ private:
 	QPoint m_clickPosition;
 	QHash<int, QVariant> m_options;
 	QHash<ChangeWatcher, QVector<QObject*> > m_changeWatchers;
+	QHash<quint64, QPixmap> m_thumbnails;
+	QHash<quint64, QSize> m_thumbnailSizes;
+	QSet<quint64> m_outdatedThumbnails;
+	QElapsedTimer m_thumbnailUpdateTimer;
 	HitTestResult m_hitResult;
 	quint64 m_windowIdentifier;
 	int m_loadingTime;
 	int m_loadingTimer;
 	int m_reloadTimer;
+	int m_thumbnailTimer;
 	int m_toolTipEntryEnumerator;
 
 	static QString m_fastForwardScript;
@@ -365,6 +376,7 @@ signals:
 	void zoomChanged(int zoom);
 	void isAudibleChanged(bool isAudible);
 	void isFullScreenChanged(bool isFullScreen);
+	void thumbnailChanged();
 };
 
 }
@@ -65,7 +65,6 @@ Window::Window(const QVariantMap &parameters, ContentsWidget *widget, MainWindow
 	m_contentsWidget(nullptr),
 	m_parameters(parameters),
 	m_identifier(++m_identifierCounter),
-	m_suspendTimer(0),
 	m_isAboutToClose(false),
 	m_isPinned(false)
 {
@@ -84,41 +83,17 @@ Window::Window(const QVariantMap &parameters, ContentsWidget *widget, MainWindow
 	connect(mainWindow, &MainWindow::toolBarStateChanged, this, &Window::handleToolBarStateChanged);
 }
 
-void Window::timerEvent(QTimerEvent *event)
-{
-	if (event->timerId() == m_suspendTimer)
-	{
-		killTimer(m_suspendTimer);
-
-		m_suspendTimer = 0;
-
-		triggerAction(ActionsManager::SuspendTabAction);
-	}
-}
-
 void Window::hideEvent(QHideEvent *event)
 {
 	QWidget::hideEvent(event);
 
-	const int suspendTime(SettingsManager::getOption(SettingsManager::Browser_InactiveTabTimeUntilSuspendOption).toInt());
-
-	if (m_suspendTimer == 0 && suspendTime >= 0)
-	{
-		m_suspendTimer = startTimer(suspendTime * 1000);
-	}
+	m_lastActivity = QDateTime::currentDateTimeUtc();
 }
 
 void Window::focusInEvent(QFocusEvent *event)
 {
 	QWidget::focusInEvent(event);
 
-	if (m_suspendTimer != 0)
-	{
-		killTimer(m_suspendTimer);
-
-		m_suspendTimer = 0;
-	}
-
 	updateFocus();
 }
 
@@ -236,13 +211,6 @@ void Window::search(const QString &query, const QString &searchEngine)
 
 void Window::markAsActive(bool updateLastActivity)
 {
-	if (m_suspendTimer != 0)
-	{
-		killTimer(m_suspendTimer);
-
-		m_suspendTimer = 0;
-	}
-
 	if (!m_contentsWidget)
 	{
 		setUrl(m_session.getUrl(), false);
@@ -505,6 +473,7 @@ void Window::setContentsWidget(ContentsWidget *widget)
 		emit urlChanged(url, false);
 	});
 	connect(m_contentsWidget, &ContentsWidget::iconChanged, this, &Window::iconChanged);
+	connect(m_contentsWidget, &ContentsWidget::thumbnailChanged, this, &Window::thumbnailChanged);
 	connect(m_contentsWidget, &ContentsWidget::requestBlocked, this, &Window::requestBlocked);
 	connect(m_contentsWidget, &ContentsWidget::arbitraryActionsStateChanged, this, &Window::arbitraryActionsStateChanged);
 	connect(m_contentsWidget, &ContentsWidget::categorizedActionsStateChanged, this, &Window::categorizedActionsStateChanged);
@@ -764,4 +733,9 @@ bool Window::isPrivate() const
 	return ((m_contentsWidget && !m_isAboutToClose) ? m_contentsWidget->isPrivate() : SessionsManager::calculateOpenHints(m_parameters).testFlag(SessionsManager::PrivateOpen));
 }
 
+bool Window::isSuspended() const
+{
+	return !m_contentsWidget;
+}
+
 }
@@ -81,6 +81,7 @@ public:
 	bool isActive() const;
 	bool isPinned() const;
 	bool isPrivate() const;
+	bool isSuspended() const;
 
 public slots:
 	void triggerAction(int identifier, const QVariantMap &parameters = {}, ActionsManager::TriggerType trigger = ActionsManager::UnknownTrigger) override;
@@ -92,7 +93,6 @@ public slots:
 	void setPinned(bool isPinned);
 
 protected:
-	void timerEvent(QTimerEvent *event) override;
 	void hideEvent(QHideEvent *event) override;
 	void focusInEvent(QFocusEvent *event) override;
 	void updateFocus();
@@ -113,7 +113,6 @@ private:
 	Session::Window m_session;
 	QVariantMap m_parameters;
 	quint64 m_identifier;
-	int m_suspendTimer;
 	bool m_isAboutToClose;
 	bool m_isPinned;
 
@@ -131,6 +130,7 @@ signals:
 	void titleChanged(const QString &title);
 	void urlChanged(const QUrl &url, bool force);
 	void iconChanged(const QIcon &icon);
+	void thumbnailChanged();
 	void requestBlocked(const NetworkManager::ResourceInformation &request);
 	void actionsStateChanged();
 	void arbitraryActionsStateChanged(const QVector<int> &identifiers);